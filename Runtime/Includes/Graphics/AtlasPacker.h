@@ -0,0 +1,23 @@
+#ifndef __SCOP_ATLAS_PACKER__
+#define __SCOP_ATLAS_PACKER__
+
+#include <vector>
+#include <cstdint>
+
+#include <Maths/Vec2.h>
+
+namespace Scop
+{
+	struct AtlasRect
+	{
+		std::uint32_t page;
+		std::uint32_t x;
+		std::uint32_t y;
+	};
+
+	// CPU only, places the rectangles on as few pages as possible.
+	// Returns false when one of them is bigger than a page
+	[[nodiscard]] bool PackAtlasRects(const std::vector<Vec2ui>& sizes, std::uint32_t page_size, std::vector<AtlasRect>& rects, std::uint32_t& page_count);
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef __SCOP_FONT__
 #define __SCOP_FONT__
 
+#include <cmath>
 #include <variant>
 #include <filesystem>
 #include <unordered_set>
@@ -11,8 +12,7 @@
 
 namespace Scop
 {
-	constexpr const int RANGE = 1024;
-
+	// Font face, glyphs are rasterised on demand by the glyph cache at the font scale (height in pixels)
 	class Font
 	{
 		public:
@@ -24,19 +24,25 @@ namespace Scop
 
 			inline const std::string& GetName() const { return m_name; }
 			inline float GetScale() const noexcept { return m_scale; }
-			inline const std::array<stbtt_packedchar, 96>& GetCharData() const { return m_cdata; }
-			inline const Texture& GetTexture() const noexcept { return m_atlas; }
+			// Glyphs are cached per whole pixel height
+			inline std::uint32_t GetSizeBucket() const noexcept { return static_cast<std::uint32_t>(std::max(1l, std::lround(m_scale))); }
+			// Shared by every font loaded from the same file so their glyphs are cached once
+			inline std::uint64_t GetID() const noexcept { return m_id; }
+			inline bool IsBuilt() const noexcept { return m_is_built; }
+			inline const stbtt_fontinfo& GetFontInfo() const noexcept { return m_info; }
+			[[nodiscard]] float GetKerning(std::uint32_t left, std::uint32_t right) const noexcept;
 			inline bool operator==(const Font& rhs) const { return rhs.m_name == m_name && rhs.m_scale == m_scale; }
 			inline bool operator!=(const Font& rhs) const { return rhs.m_name != m_name || rhs.m_scale != m_scale; }
 
 			inline ~Font() { Destroy(); }
 
 		private:
-			std::array<stbtt_packedchar, 96> m_cdata;
-			Texture m_atlas;
-			std::variant<std::filesystem::path, std::vector<std::uint8_t>> m_build_data;
+			stbtt_fontinfo m_info;
+			std::variant<std::filesystem::path, std::vector<std::uint8_t>> m_build_data; // Holds the TTF bytes once built
 			std::string m_name;
+			std::uint64_t m_id = 0;
 			float m_scale;
+			bool m_is_built = false;
 	};
 
 	class FontRegistry
@@ -0,0 +1,105 @@
+#ifndef __SCOP_GLYPH_CACHE__
+#define __SCOP_GLYPH_CACHE__
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include <Maths/Vec2.h>
+#include <Utils/Buffer.h>
+#include <Renderer/Image.h>
+
+namespace Scop
+{
+	constexpr const std::uint32_t GLYPH_CACHE_PAGE_SIZE = 1024;
+	constexpr const std::uint32_t GLYPH_CACHE_MAX_PAGES = 4;
+	constexpr const std::uint32_t GLYPH_CACHE_NO_PAGE = 0xFFFFFFFF; // Glyphs without pixels, like spaces
+	constexpr const std::uint32_t GLYPH_PADDING = 1;
+
+	struct Glyph
+	{
+		Vec2f uv_min;
+		Vec2f uv_max;
+		Vec2f offset; // Top left corner relative to the pen position on the baseline
+		Vec2f size;
+		float advance;
+		std::uint32_t page = GLYPH_CACHE_NO_PAGE;
+	};
+
+	// Glyphs of every font and size, rasterised on first use into R8 pages packed with shelves.
+	// When every page is full the least recently used page that no frame in flight can sample is cleared
+	class GlyphCache
+	{
+		public:
+			GlyphCache() = default;
+
+			void Init() noexcept;
+			void Destroy() noexcept;
+
+			// Returns nullptr when the glyph does not fit anywhere, the pointer is valid until the next eviction.
+			// Glyphs larger than a page are returned without pixels
+			[[nodiscard]] const Glyph* GetGlyph(const class Font& font, std::uint32_t codepoint);
+			void MarkPageUsed(std::uint32_t page) noexcept;
+			// Uploads glyphs rasterised since the last flush
+			void Flush();
+			// Called once per frame after the frame fence has been waited
+			void Update() noexcept;
+
+			[[nodiscard]] inline Texture& GetPageTexture(std::uint32_t page) { return m_pages.at(page)->texture; }
+			[[nodiscard]] inline std::uint32_t GetPageGeneration(std::uint32_t page) const { return m_pages.at(page)->generation; }
+			[[nodiscard]] inline std::size_t GetPageCount() const noexcept { return m_pages.size(); }
+			[[nodiscard]] inline std::size_t GetGlyphCount() const noexcept { return m_glyphs.size(); }
+
+			~GlyphCache() = default;
+
+		private:
+			struct Key
+			{
+				std::uint64_t font;
+				std::uint32_t codepoint;
+				std::uint32_t size;
+
+				inline bool operator==(const Key& rhs) const noexcept { return font == rhs.font && codepoint == rhs.codepoint && size == rhs.size; }
+			};
+
+			struct KeyHasher
+			{
+				std::size_t operator()(const Key& key) const noexcept;
+			};
+
+			struct Shelf
+			{
+				std::uint32_t y;
+				std::uint32_t height;
+				std::uint32_t x;
+			};
+
+			struct Page
+			{
+				Texture texture;
+				CPUBuffer pixels;
+				std::vector<Shelf> shelves;
+				std::uint64_t last_use_frame = 0;
+				std::uint32_t next_shelf_y = 0;
+				std::uint32_t generation = 0;
+				std::uint32_t dirty_min_x = GLYPH_CACHE_PAGE_SIZE;
+				std::uint32_t dirty_min_y = GLYPH_CACHE_PAGE_SIZE;
+				std::uint32_t dirty_max_x = 0;
+				std::uint32_t dirty_max_y = 0;
+			};
+
+			[[nodiscard]] bool Allocate(Page& page, std::uint32_t width, std::uint32_t height, std::uint32_t& x, std::uint32_t& y) noexcept;
+			[[nodiscard]] bool FindSpace(std::uint32_t width, std::uint32_t height, std::uint32_t& page, std::uint32_t& x, std::uint32_t& y);
+			void EvictPage(std::uint32_t page) noexcept;
+
+		private:
+			std::unordered_map<Key, Glyph, KeyHasher> m_glyphs;
+			std::vector<std::unique_ptr<Page>> m_pages;
+			std::uint64_t m_frame = 0;
+			bool m_warned_full = false;
+			bool m_warned_oversized = false;
+	};
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <vector>
 #include <cstdint>
 #include <optional>
+#include <functional>
 #include <filesystem>
 
 #include <Maths/Vec2.h>
@@ -44,6 +45,7 @@ namespace Scop
 		std::map<std::string, FaceList> faces;
 	};
 
+	// Attributes of each distinct (v, t, n) combination, faces index them
 	struct ObjModel
 	{
 		std::vector<Vec4f> color;
@@ -54,10 +56,38 @@ namespace Scop
 		std::map<std::string, std::vector<std::uint32_t>> faces;
 	};
 
+	constexpr const std::uint64_t OBJ_STREAMING_THRESHOLD = 512 * 1024 * 1024; // Bigger files are streamed by LoadModelFromObjFile
+	constexpr const std::uint32_t OBJ_STREAM_CHUNK_VERTICES = 64 * 1024;
+	constexpr const std::uint32_t OBJ_STREAM_INDICES_PER_VERTEX = 6; // Bounds the indices of a chunk, about what closed meshes use
+
+	// Bounded part of a group, laid out like an ObjModel with its own vertices
+	struct ObjModelChunk
+	{
+		std::string group;
+		std::vector<Vec4f> color;
+		std::vector<Vec3f> vertex;
+		std::vector<Vec3f> normal;
+		std::vector<Vec2f> tex_coord;
+		std::vector<std::uint32_t> indices;
+	};
+
+	struct ObjStreamInfos
+	{
+		Vec3f aabb_min;
+		Vec3f aabb_max;
+		std::size_t chunk_count = 0;
+	};
+
 	std::optional<ObjData> LoadObjFromFile(const std::filesystem::path& path);
 	void TesselateObjData(ObjData& data);
 	ObjModel ConvertObjDataToObjModel(const ObjData& data);
 
+	// Never holds the faces of the whole file: the mapping is read in passes and each group is cut in triangulated
+	// chunks of at most chunk_vertices vertices, given to the callback as soon as they are full.
+	// Attributes are kept since faces may use any of them. Missing normals are averaged over the faces around
+	// each position, without crease. The bounds of infos are set before the first chunk is emitted
+	bool StreamObjFile(const std::filesystem::path& path, std::uint32_t chunk_vertices, ObjStreamInfos& infos, const std::function<void(const ObjModelChunk&)>& callback);
+
 	template<typename T>
 	inline std::istream& operator>>(std::istream& in, std::vector<T>& vec);
 
@@ -67,6 +97,21 @@ namespace Scop
 	inline std::istream& operator>>(std::istream& in, ObjData::FaceVertex& f);
 }
 
+namespace std
+{
+	template <>
+	struct hash<Scop::ObjData::FaceVertex>
+	{
+		std::size_t operator()(const Scop::ObjData::FaceVertex& f) const noexcept
+		{
+			std::size_t hash = std::hash<std::int32_t>{}(f.v);
+			hash ^= std::hash<std::int32_t>{}(f.t) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<std::int32_t>{}(f.n) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			return hash;
+		}
+	};
+}
+
 #include <Graphics/Loaders/OBJ.inl>
 
 #endif
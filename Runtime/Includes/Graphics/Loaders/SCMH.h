@@ -0,0 +1,104 @@
+#ifndef __SCOP_SCMH_LOADER__
+#define __SCOP_SCMH_LOADER__
+
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+
+#include <Maths/Vec3.h>
+#include <Renderer/Vertex.h>
+#include <Platform/MappedFile.h>
+
+// Scop mesh cache: a header, the sub meshes payload and a sub mesh table.
+// Each sub mesh is its vertices directly followed by its indices, laid out as the GPU reads them,
+// and starts at an SCMH_DATA_ALIGNMENT aligned file offset so it can be copied to a staging buffer as is.
+// The table comes last so sub meshes can be written as soon as they are built
+
+namespace Scop
+{
+	constexpr const std::uint32_t SCMH_MAGIC = 0x484D4353; // "SCMH"
+	constexpr const std::uint32_t SCMH_VERSION = 2;
+	constexpr const std::size_t SCMH_DATA_ALIGNMENT = 16;
+
+	constexpr const std::uint32_t SCMH_FLAG_OPTIMIZED = 1 << 0; // Triangles and vertices were reordered by OptimizeMesh
+
+	// Identifies the file a cache was generated from
+	struct SCMHSourceStamp
+	{
+		std::uint64_t size = 0;
+		std::int64_t mtime = 0;
+		std::uint64_t hash = 0; // FNV-1a of the content, only checked when the modification time changed
+	};
+
+	struct SCMHHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t vertex_size; // sizeof(Vertex) when written
+		std::uint32_t submesh_count;
+		SCMHSourceStamp source;
+		float build_parameter; // Crease angle used to generate normals
+		float aabb_min[3];
+		float aabb_max[3];
+		std::uint32_t flags;
+		std::uint64_t table_offset;
+	};
+
+	struct SCMHSubMesh
+	{
+		std::uint64_t offset; // From the start of the file
+		std::uint32_t vertex_count;
+		std::uint32_t index_count;
+	};
+
+	struct SCMHInfos
+	{
+		std::vector<SCMHSubMesh> submeshes;
+		SCMHSourceStamp source;
+		Vec3f aabb_min;
+		Vec3f aabb_max;
+		float build_parameter;
+		std::uint32_t flags;
+	};
+
+	struct SCMHSubMeshData
+	{
+		std::vector<Vertex> vertices;
+		std::vector<std::uint32_t> indices;
+	};
+
+	[[nodiscard]] SCMHSourceStamp ComputeSCMHSourceStamp(const std::filesystem::path& source, bool with_hash);
+	// Cheap size and modification time check first, the content hash is only computed when they are not enough
+	[[nodiscard]] bool IsSCMHUpToDate(const SCMHInfos& infos, const std::filesystem::path& source);
+
+	// Maps the file, sub mesh data can then be read from file.GetData() + infos.submeshes[i].offset
+	bool LoadSCMHFile(const std::filesystem::path& path, MappedFile& file, SCMHInfos& infos);
+	// Writes sub meshes one by one to a temporary file that replaces the cache once finished
+	class SCMHWriter
+	{
+		public:
+			SCMHWriter() = default;
+
+			bool Open(const std::filesystem::path& path);
+			void AddSubMesh(const Vertex* vertices, std::uint32_t vertex_count, const std::uint32_t* indices, std::uint32_t index_count);
+			bool Finish(const SCMHSourceStamp& source, float build_parameter, std::uint32_t flags, Vec3f aabb_min, Vec3f aabb_max);
+
+			[[nodiscard]] inline bool IsOpen() const noexcept { return m_file.is_open(); }
+
+			~SCMHWriter();
+
+		private:
+			void Pad();
+
+		private:
+			std::ofstream m_file;
+			std::vector<SCMHSubMesh> m_table;
+			std::filesystem::path m_path;
+			std::filesystem::path m_temporary_path;
+	};
+
+	bool WriteSCMHFile(const std::filesystem::path& path, const SCMHSourceStamp& source, float build_parameter, std::uint32_t flags, Vec3f aabb_min, Vec3f aabb_max, const std::vector<SCMHSubMeshData>& submeshes);
+}
+
+#endif
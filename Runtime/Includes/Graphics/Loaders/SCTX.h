@@ -0,0 +1,49 @@
+#ifndef __SCOP_SCTX_LOADER__
+#define __SCOP_SCTX_LOADER__
+
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include <kvf.h>
+#include <Maths/Vec2.h>
+#include <Utils/Buffer.h>
+
+// Scop texture container: a header, a mip table and the mips payload, finest mip first.
+// Every mip starts at an SCTX_DATA_ALIGNMENT aligned file offset so the file can be uploaded as is
+
+namespace Scop
+{
+	constexpr const std::uint32_t SCTX_MAGIC = 0x58544353; // "SCTX"
+	constexpr const std::uint32_t SCTX_VERSION = 1;
+	constexpr const std::size_t SCTX_DATA_ALIGNMENT = 16;
+
+	struct SCTXHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t format; // VkFormat
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t mip_count;
+	};
+
+	struct SCTXMip
+	{
+		std::uint64_t offset; // From the start of the file
+		std::uint64_t size;
+	};
+
+	struct SCTXInfos
+	{
+		std::vector<std::size_t> mip_offsets;
+		Vec2ui32 dimensions;
+		VkFormat format;
+	};
+
+	// Reads the whole file at once, the returned buffer and infos.mip_offsets can be given to Texture::InitFromMipChain
+	CPUBuffer LoadSCTXFile(const std::filesystem::path& path, SCTXInfos& infos);
+	bool WriteSCTXFile(const std::filesystem::path& path, VkFormat format, Vec2ui32 dimensions, const std::vector<CPUBuffer>& mips);
+}
+
+#endif
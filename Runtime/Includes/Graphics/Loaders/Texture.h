@@ -0,0 +1,17 @@
+#ifndef __SCOP_TEXTURE_LOADER__
+#define __SCOP_TEXTURE_LOADER__
+
+#include <memory>
+#include <filesystem>
+
+#include <Renderer/Image.h>
+#include <Renderer/Enums.h>
+
+namespace Scop
+{
+	// Picks the loader from the extension. SCTX files keep their precompiled mip chain, only its first mip is used with TextureMipmapMode::None.
+	// Returns nullptr if the file could not be loaded or its format cannot be sampled by the device, callers may then fall back to the BMP source
+	std::shared_ptr<Texture> LoadTextureFromFile(const std::filesystem::path& path, TextureMipmapMode mipmaps = TextureMipmapMode::Stream);
+}
+
+#endif
@@ -4,12 +4,16 @@
 #include <memory>
 
 #include <Core/EventBus.h>
+#include <Maths/Mat4.h>
 #include <Renderer/Image.h>
 #include <Renderer/Buffer.h>
 #include <Renderer/Descriptor.h>
+#include <Renderer/MaterialTable.h>
 
 namespace Scop
 {
+	constexpr const std::uint32_t MATERIAL_INDEX_PUSH_CONSTANT_OFFSET = sizeof(Mat4f) * 2; // Right after the model and normal matrices of the forward shaders
+
 	struct MaterialTextures
 	{
 		std::shared_ptr<Texture> albedo;
@@ -20,7 +24,7 @@ namespace Scop
 		float dissolve_texture_factor = 1.0f;
 		float dissolve_black_white_colors_factor = 1.0f;
 		float dissolve_normals_colors_factor = 0.0f;
-		std::uint8_t __padding[4];
+		std::uint32_t albedo_texture_index = BINDLESS_INVALID_INDEX; // Slot in the bindless texture table, fills the std140 padding
 	};
 
 	class Material
@@ -28,53 +32,84 @@ namespace Scop
 		friend class Model;
 
 		public:
-			Material() { m_data_buffer.Init(sizeof(m_data)); SetupEventListener(); }
-			Material(const MaterialTextures& textures) : m_textures(textures) { m_data_buffer.Init(sizeof(m_data)); SetupEventListener(); }
+			Material() { Register(); SetupEventListener(); }
+			Material(const MaterialTextures& textures) : m_textures(textures) { Register(); SetupEventListener(); }
+
+			inline void SetMaterialData(const MaterialData& data) noexcept
+			{
+				m_data = data;
+				m_data.albedo_texture_index = m_textures.albedo ? m_textures.albedo->GetBindlessIndex() : BINDLESS_INVALID_INDEX;
+				RenderCore::Get().GetMaterialTable().SetData(m_slot, &m_data);
+			}
 
-			inline void SetMaterialData(const MaterialData& data) noexcept { m_data = data; }
+			[[nodiscard]] inline std::uint32_t GetSlot() const noexcept { return m_slot; }
 
-			~Material() { m_data_buffer.Destroy(); }
+			~Material()
+			{
+				if(RenderCore::IsInit())
+					RenderCore::Get().GetMaterialTable().Release(m_slot);
+			}
 
 		private:
-			[[nodiscard]] inline bool IsSetInit() const noexcept { return p_set && p_set->IsInit(); }
-			[[nodiscard]] inline VkDescriptorSet GetSet(std::size_t frame_index) const noexcept { return p_set->GetSet(frame_index); }
+			[[nodiscard]] inline bool IsSetInit() const noexcept { return m_set.IsInit(); }
+			[[nodiscard]] inline VkDescriptorSet GetSet(std::size_t frame_index) const noexcept { return m_set.GetSet(frame_index); }
+
+			inline void Register()
+			{
+				m_slot = RenderCore::Get().GetMaterialTable().Register();
+				SetMaterialData(m_data);
+			}
 
 			inline void SetupEventListener()
 			{
 				std::function<void(const EventBase&)> functor = [this](const EventBase& event)
 				{
 					if(event.What() == Event::FrameBeginEventCode)
-						m_have_been_updated_this_frame = false;
+					{
+						m_data_flushed_this_frame = false;
+						m_set_updated_this_frame = false;
+					}
 				};
 				EventBus::RegisterListener({ functor, "__ScopMaterial" + std::to_string(reinterpret_cast<std::uintptr_t>(this)) });
 			}
 
 			inline void UpdateDescriptorSet(std::shared_ptr<DescriptorSet> set)
 			{
-				p_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(set->GetShaderLayout(), set->GetShaderType());
+				m_set.Init(set->GetShaderLayout(), set->GetShaderType());
 			}
 
-			inline void Bind(std::size_t frame_index, VkCommandBuffer cmd)
+			// Enough for pipelines using bindless textures, they read the material straight from the table
+			inline void FlushData(std::size_t frame_index)
 			{
-				if(m_have_been_updated_this_frame)
+				if(m_data_flushed_this_frame)
 					return;
-				p_set->SetImage(frame_index, 0, *m_textures.albedo);
-				p_set->SetUniformBuffer(frame_index, 1, m_data_buffer.Get(frame_index));
-				p_set->Update(frame_index, cmd);
-
-				static CPUBuffer buffer(sizeof(MaterialData));
-				std::memcpy(buffer.GetData(), &m_data, buffer.GetSize());
-				m_data_buffer.SetData(buffer, frame_index);
+				m_textures.albedo->MarkUsed();
+				// Streamed textures change their bindless slot when their resident mips change
+				if(m_data.albedo_texture_index != m_textures.albedo->GetBindlessIndex())
+					SetMaterialData(m_data);
+				RenderCore::Get().GetMaterialTable().Flush(m_slot, frame_index);
+				m_data_flushed_this_frame = true;
+			}
 
-				m_have_been_updated_this_frame = true;
+			inline void Bind(std::size_t frame_index, VkCommandBuffer cmd)
+			{
+				FlushData(frame_index);
+				if(m_set_updated_this_frame)
+					return;
+				MaterialTable& table = RenderCore::Get().GetMaterialTable();
+				m_set.SetImage(0, *m_textures.albedo);
+				m_set.SetStorageBuffer(1, table.GetBuffer(), table.GetSlotOffset(m_slot, frame_index), table.GetSlotSize());
+				m_set.Update(frame_index, cmd);
+				m_set_updated_this_frame = true;
 			}
 
 		private:
-			UniformBuffer m_data_buffer;
 			MaterialTextures m_textures;
 			MaterialData m_data;
-			std::shared_ptr<DescriptorSet> p_set;
-			bool m_have_been_updated_this_frame = false;
+			TransientDescriptorSet m_set;
+			std::uint32_t m_slot = MATERIAL_TABLE_INVALID_SLOT;
+			bool m_data_flushed_this_frame = false;
+			bool m_set_updated_this_frame = false;
 	};
 }
 
@@ -30,6 +30,14 @@ namespace Scop
 					triangle_count = this->index_size / 3;
 				}
 
+				// Vertices directly followed by their indices, as stored in mesh cache files
+				inline SubMesh(const void* data, std::size_t vertex_count, std::size_t index_count)
+				{
+					buffer.InitFromMemory(vertex_count * sizeof(Vertex), index_count * sizeof(std::uint32_t), data);
+					index_size = index_count;
+					triangle_count = index_size / 3;
+				}
+
 				inline void SetData(const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices, std::size_t index_size = 0)
 				{
 					CPUBuffer vertex_data(vertices.size() * sizeof(Scop::Vertex));
@@ -0,0 +1,37 @@
+#ifndef __SCOP_MESH_OPTIMIZER__
+#define __SCOP_MESH_OPTIMIZER__
+
+#include <vector>
+#include <cstdint>
+
+#include <Renderer/Vertex.h>
+
+namespace Scop
+{
+	constexpr const std::uint32_t MESH_OPTIMIZER_CACHE_SIZE = 16; // Post transform cache entries the reordering aims for
+	constexpr const float MESH_OPTIMIZER_OVERDRAW_THRESHOLD = 1.05f; // Cache efficiency that may be traded for less overdraw
+
+	struct VertexCacheStatistics
+	{
+		float acmr = 0.0f; // Transformed vertices per triangle, 0.5 at best on big meshes
+		float atvr = 0.0f; // Transformed vertices per used vertex, 1 at best
+		std::size_t misses = 0;
+	};
+
+	// CPU only, simulates a FIFO post transform cache
+	[[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(const std::vector<std::uint32_t>& indices, std::size_t vertex_count, std::uint32_t cache_size = MESH_OPTIMIZER_CACHE_SIZE);
+
+	// Tipsify triangle reordering (Sander et al. 2007), linear in the number of triangles.
+	// clusters receives the first triangle of each run that had to restart away from the previous one
+	void OptimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertex_count, std::vector<std::uint32_t>* clusters = nullptr, std::uint32_t cache_size = MESH_OPTIMIZER_CACHE_SIZE);
+	// Cuts the clusters further while the cache miss ratio stays under threshold times the mesh one,
+	// then draws first the clusters that face away from the mesh centre as they are the most likely to occlude others
+	void OptimizeOverdraw(std::vector<std::uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& clusters, float threshold = MESH_OPTIMIZER_OVERDRAW_THRESHOLD, std::uint32_t cache_size = MESH_OPTIMIZER_CACHE_SIZE);
+	// Renumbers vertices in the order they are first used, unused vertices are removed
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+
+	// All of the above, indices must be a triangle list
+	void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+}
+
+#endif
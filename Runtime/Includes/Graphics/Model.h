@@ -7,6 +7,7 @@
 #include <kvf.h>
 
 #include <Maths/Vec3.h>
+#include <Maths/Angles.h>
 #include <Graphics/Mesh.h>
 #include <Graphics/Material.h>
 
@@ -16,7 +17,7 @@ namespace Scop
 	class Model
 	{
 		friend class ScopEngine;
-		friend Model LoadModelFromObjFile(std::filesystem::path path) noexcept;
+		friend Model LoadModelFromObjFile(std::filesystem::path path, DegreeAnglef crease_angle, bool optimize) noexcept;
 
 		public:
 			Model() = default;
@@ -30,6 +31,7 @@ namespace Scop
 			[[nodiscard]] inline Vec3f GetCenter() const noexcept { return m_center; }
 			[[nodiscard]] inline std::shared_ptr<Mesh> GetMesh() const { return p_mesh; }
 
+			// set is the per material set template, or the material table set when the pipeline uses bindless textures
 			void Draw(VkCommandBuffer cmd, std::shared_ptr<DescriptorSet> matrices_set, const class GraphicPipeline& pipeline, std::shared_ptr<DescriptorSet> set, std::size_t& drawcalls, std::size_t& polygondrawn, std::size_t frame_index) const;
 
 			~Model() = default;
@@ -42,7 +44,9 @@ namespace Scop
 			std::shared_ptr<Mesh> p_mesh;
 	};
 
-	Model LoadModelFromObjFile(std::filesystem::path path) noexcept;
+	// Normals are generated when the file has none, faces further apart than the crease angle stay sharp.
+	// Sub meshes are reordered for the vertex cache and overdraw unless optimize is false
+	Model LoadModelFromObjFile(std::filesystem::path path, DegreeAnglef crease_angle = 89.0f, bool optimize = true) noexcept;
 }
 
 #endif
@@ -44,13 +44,14 @@ namespace Scop
 			{
 				std::shared_ptr<DescriptorSet> matrices_set;
 				std::shared_ptr<DescriptorSet> albedo_set;
+				std::shared_ptr<DescriptorSet> material_table_set; // Whole material table, only with bindless textures
 				std::shared_ptr<UniformBuffer> matrices_buffer;
 				bool wireframe = false;
 			};
 
 			struct PostProcessData
 			{
-				std::shared_ptr<DescriptorSet> set;
+				TransientDescriptorSet set;
 				std::shared_ptr<UniformBuffer> data_buffer;
 				CPUBuffer data;
 			};
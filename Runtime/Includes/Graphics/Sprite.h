@@ -6,7 +6,6 @@
 #include <Maths/Vec2.h>
 #include <Maths/Vec4.h>
 #include <Core/Script.h>
-#include <Graphics/Mesh.h>
 #include <Renderer/Descriptor.h>
 #include <Renderer/Image.h>
 
@@ -26,11 +25,16 @@ namespace Scop
 			inline void SetColor(Vec4f color) noexcept { m_color = color; }
 			inline void SetPosition(Vec2ui position) noexcept { m_position = position; }
 			inline void SetScale(Vec2f scale) noexcept { m_scale = scale; }
+			// Part of the texture to draw, used for sprites packed in a texture atlas
+			inline void SetTextureRegion(Vec2f uv_min, Vec2f uv_max) noexcept { m_uv_min = uv_min; m_uv_max = uv_max; }
 
 			[[nodiscard]] inline const Vec4f& GetColor() const noexcept { return m_color; }
 			[[nodiscard]] inline const Vec2ui& GetPosition() const noexcept { return m_position; }
 			[[nodiscard]] inline const Vec2f& GetScale() const noexcept { return m_scale; }
-			[[nodiscard]] inline std::shared_ptr<Mesh> GetMesh() const { return p_mesh; }
+			[[nodiscard]] inline const Vec2f& GetUVMin() const noexcept { return m_uv_min; }
+			[[nodiscard]] inline const Vec2f& GetUVMax() const noexcept { return m_uv_max; }
+			// Size in pixels of the drawn texture region, before scaling
+			[[nodiscard]] inline Vec2f GetSize() const noexcept { return Vec2f{ static_cast<float>(p_texture->GetWidth()), static_cast<float>(p_texture->GetHeight()) } * (m_uv_max - m_uv_min); }
 			[[nodiscard]] inline std::shared_ptr<Texture> GetTexture() const { return p_texture; }
 			[[nodiscard]] inline std::uint64_t GetUUID() const noexcept { return m_uuid; }
 
@@ -47,6 +51,10 @@ namespace Scop
 
 			inline void Bind(std::size_t frame_index, VkCommandBuffer cmd)
 			{
+				p_texture->MarkUsed();
+				// No set with bindless textures
+				if(!p_set)
+					return;
 				p_set->SetImage(frame_index, 0, *p_texture);
 				p_set->Update(frame_index, cmd);
 			}
@@ -55,10 +63,11 @@ namespace Scop
 			std::shared_ptr<DescriptorSet> p_set;
 			std::shared_ptr<Texture> p_texture;
 			std::shared_ptr<class SpriteScript> p_script;
-			std::shared_ptr<Mesh> p_mesh;
 			Vec4f m_color = Vec4f{ 1.0f, 1.0f, 1.0f, 1.0f };
 			Vec2ui m_position = Vec2ui{ 0, 0 };
 			Vec2f m_scale = Vec2f{ 1.0f, 1.0f };
+			Vec2f m_uv_min = Vec2f{ 0.0f, 0.0f };
+			Vec2f m_uv_max = Vec2f{ 1.0f, 1.0f };
 			std::uint64_t m_uuid;
 	};
 }
@@ -1,9 +1,10 @@
 #ifndef __SCOP_TEXT__
 #define __SCOP_TEXT__
 
+#include <span>
+
 #include <Graphics/Font.h>
-#include <Graphics/Mesh.h>
-#include <Renderer/Descriptor.h>
+#include <Renderer/DynamicQuadBuffer.h>
 
 namespace Scop
 {
@@ -14,6 +15,8 @@ namespace Scop
 		public:
 			Text(std::uint64_t uuid, const std::string& text, std::shared_ptr<Font> font);
 
+			// Only the glyph quads that differ from the previous text are uploaded
+			void SetText(const std::string& text);
 			inline void SetColor(Vec4f color) noexcept { m_color = color; }
 			inline void SetPosition(Vec2ui position) noexcept { m_position = position; }
 			inline void SetScale(Vec2f scale) noexcept { m_scale = scale; }
@@ -23,27 +26,39 @@ namespace Scop
 			[[nodiscard]] inline const Vec4f& GetColor() const noexcept { return m_color; }
 			[[nodiscard]] inline const Vec2ui& GetPosition() const noexcept { return m_position; }
 			[[nodiscard]] inline const Vec2f& GetScale() const noexcept { return m_scale; }
-			[[nodiscard]] inline std::shared_ptr<Mesh> GetMesh() const { return p_mesh; }
 			[[nodiscard]] inline std::uint64_t GetUUID() const noexcept { return m_uuid; }
 
 			virtual ~Text() = default;
 
 		private:
-			[[nodiscard]] inline bool IsSetInit() const noexcept { return p_set && p_set->IsInit(); }
-			[[nodiscard]] inline VkDescriptorSet GetSet(std::size_t frame_index) const noexcept { return p_set->GetSet(frame_index); }
-			inline void UpdateDescriptorSet(std::shared_ptr<DescriptorSet> set)
+			struct Page
 			{
-				p_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(set->GetShaderLayout(), set->GetShaderType());
-			}
-			inline void Bind(std::size_t frame_index, VkCommandBuffer cmd)
+				std::uint32_t index; // Glyph cache page
+				std::uint32_t generation;
+				std::uint32_t first_quad;
+				std::uint32_t quad_count;
+			};
+
+			struct GlyphQuad
 			{
-				p_set->SetImage(frame_index, 0, const_cast<Texture&>(p_font->GetTexture()));
-				p_set->Update(frame_index, cmd);
-			}
+				Quad quad;
+				std::uint32_t page;
+			};
+
+		private:
+			void BuildMesh();
+			// Rebuilds the quads if one of their glyph cache pages got evicted and keeps the pages alive
+			void Prepare();
+			[[nodiscard]] inline std::size_t GetPageCount() const noexcept { return m_pages.size(); }
+			[[nodiscard]] inline std::uint32_t GetGlyphCachePage(std::size_t page) const noexcept { return m_pages[page].index; }
+			// Text space quads, the 2D pass places them on screen and merges them with the sprites sharing the page
+			[[nodiscard]] inline std::span<const Quad> GetPageQuads(std::size_t page) const noexcept { return std::span<const Quad>(m_quads).subspan(m_pages[page].first_quad, m_pages[page].quad_count); }
 
 		private:
-			std::shared_ptr<DescriptorSet> p_set;
-			std::shared_ptr<Mesh> p_mesh;
+			std::vector<Page> m_pages;
+			std::vector<GlyphQuad> m_glyph_quads; // Layout scratch kept to avoid allocations on updates
+			std::vector<std::uint32_t> m_page_scratch;
+			std::vector<Quad> m_quads; // Grouped by page
 			std::shared_ptr<Font> p_font;
 			std::string m_text;
 			Vec4f m_color = Vec4f{ 1.0f, 1.0f, 1.0f, 1.0f };
@@ -0,0 +1,61 @@
+#ifndef __SCOP_TEXTURE_ATLAS__
+#define __SCOP_TEXTURE_ATLAS__
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include <Maths/Vec2.h>
+#include <Utils/Buffer.h>
+#include <Renderer/Image.h>
+#include <Graphics/AtlasPacker.h>
+
+namespace Scop
+{
+	constexpr const std::uint32_t TEXTURE_ATLAS_DEFAULT_PAGE_SIZE = 2048;
+	constexpr const std::uint32_t TEXTURE_ATLAS_PADDING = 1; // Texels around each image, filled by extruding its borders
+
+	struct AtlasRegion
+	{
+		std::shared_ptr<Texture> texture;
+		Vec2f uv_min;
+		Vec2f uv_max;
+	};
+
+	// Packs many small RGBA8 sprite images into shared pages so sprites using them can be drawn together
+	class TextureAtlas
+	{
+		public:
+			TextureAtlas(std::uint32_t page_size = TEXTURE_ATLAS_DEFAULT_PAGE_SIZE) : m_page_size(page_size) {}
+
+			// Returns the index of the region the image will have once the atlas is built
+			std::uint32_t AddImage(CPUBuffer pixels, std::uint32_t width, std::uint32_t height);
+			std::uint32_t AddImage(const std::filesystem::path& path);
+			// Packs and uploads every image added so far, previous pages are replaced
+			bool Build(std::string_view name = {});
+			void Destroy() noexcept;
+
+			[[nodiscard]] inline const AtlasRegion& GetRegion(std::uint32_t index) const { return m_regions.at(index); }
+			[[nodiscard]] inline std::size_t GetRegionCount() const noexcept { return m_regions.size(); }
+			[[nodiscard]] inline std::size_t GetPageCount() const noexcept { return m_pages.size(); }
+
+			~TextureAtlas() = default;
+
+		private:
+			struct PendingImage
+			{
+				CPUBuffer pixels;
+				std::uint32_t width;
+				std::uint32_t height;
+			};
+
+		private:
+			std::vector<PendingImage> m_images;
+			std::vector<AtlasRegion> m_regions;
+			std::vector<std::shared_ptr<Texture>> m_pages;
+			std::uint32_t m_page_size;
+	};
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __SCOP_PLATFORM_MAPPED_FILE__
+#define __SCOP_PLATFORM_MAPPED_FILE__
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include <Utils/NonCopyable.h>
+
+namespace Scop
+{
+	// Read only memory mapping of a whole file
+	class MappedFile : public NonCopyable
+	{
+		public:
+			MappedFile() = default;
+			MappedFile(const std::filesystem::path& path) { Open(path); }
+			MappedFile(MappedFile&& other) noexcept;
+			MappedFile& operator=(MappedFile&& other) noexcept;
+
+			bool Open(const std::filesystem::path& path);
+			void Close() noexcept;
+			// Drops the pages of an already read range from memory, they are read again from the file if accessed
+			void Release(const char* begin, const char* end) noexcept;
+
+			[[nodiscard]] inline const char* GetData() const noexcept { return p_data; }
+			[[nodiscard]] inline std::size_t GetSize() const noexcept { return m_size; }
+			[[nodiscard]] inline std::string_view GetView() const noexcept { return { p_data, m_size }; }
+			[[nodiscard]] inline bool IsOpen() const noexcept { return p_data != nullptr || m_fd != -1; }
+
+			~MappedFile() override { Close(); }
+
+		private:
+			const char* p_data = nullptr;
+			std::size_t m_size = 0;
+			int m_fd = -1;
+	};
+}
+
+#endif
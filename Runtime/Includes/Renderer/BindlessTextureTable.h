@@ -0,0 +1,50 @@
+#ifndef __SCOP_BINDLESS_TEXTURE_TABLE__
+#define __SCOP_BINDLESS_TEXTURE_TABLE__
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <kvf.h>
+
+namespace Scop
+{
+	constexpr const std::uint32_t BINDLESS_INVALID_INDEX = 0xFFFFFFFF;
+	constexpr const std::uint32_t BINDLESS_TEXTURE_CAPACITY = 4096;
+	constexpr const int BINDLESS_TEXTURE_SET = 2; // Set index the bindless shaders declare the table at
+
+	// One global update-after-bind array of combined image samplers, textures keep the same slot for their whole life
+	class BindlessTextureTable
+	{
+		public:
+			BindlessTextureTable() = default;
+
+			void Init(std::uint32_t capacity = BINDLESS_TEXTURE_CAPACITY);
+			void Destroy() noexcept;
+
+			[[nodiscard]] std::uint32_t Register(const class Image& image);
+			// The slot may still be read by frames in flight, it is only reused MAX_FRAMES_IN_FLIGHT frames later
+			void Release(std::uint32_t index) noexcept;
+			// To be called once per frame, after waiting for the frame fence
+			void Update();
+
+			[[nodiscard]] inline VkDescriptorSetLayout GetLayout() const noexcept { return m_layout; }
+			[[nodiscard]] inline VkDescriptorSet GetSet() const noexcept { return m_set; }
+			[[nodiscard]] inline std::uint32_t GetCapacity() const noexcept { return m_capacity; }
+			[[nodiscard]] inline std::uint32_t GetUsedCount() const noexcept { return m_next_index - static_cast<std::uint32_t>(m_free_indices.size() + m_retired_indices.size()); }
+
+			~BindlessTextureTable() = default;
+
+		private:
+			std::vector<std::uint32_t> m_free_indices;
+			std::vector<std::pair<std::uint32_t, std::uint64_t>> m_retired_indices; // Slot and frame it was released on
+			VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+			VkDescriptorPool m_pool = VK_NULL_HANDLE;
+			VkDescriptorSet m_set = VK_NULL_HANDLE;
+			std::uint32_t m_capacity = 0;
+			std::uint64_t m_frame = 0;
+			std::uint32_t m_next_index = 0;
+	};
+}
+
+#endif
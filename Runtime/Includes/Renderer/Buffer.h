@@ -16,6 +16,8 @@ namespace Scop
 			GPUBuffer() = default;
 
 			void Init(BufferType type, VkDeviceSize size, VkBufferUsageFlags usage, CPUBuffer data, std::string_view name = {}, bool dedicated_alloc = false);
+			// Copies the data straight into the host visible memory, for data that does not live in a CPUBuffer (memory mapped files)
+			void InitFromMemory(BufferType type, VkDeviceSize size, VkBufferUsageFlags usage, const void* data, std::size_t data_size, std::string_view name = {}, bool dedicated_alloc = false);
 			void Destroy() noexcept;
 
 			bool CopyFrom(const GPUBuffer& buffer, std::size_t src_offset = 0, std::size_t dst_offset = 0) noexcept;
@@ -81,6 +83,13 @@ namespace Scop
 				m_index_offset = vertex_size;
 				GPUBuffer::Init(BufferType::LowDynamic, vertex_size + index_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additional_flags, std::move(data), std::move(name), false);
 			}
+			// Vertices directly followed by indices
+			inline void InitFromMemory(std::uint32_t vertex_size, std::uint32_t index_size, const void* data, std::string_view name = {})
+			{
+				m_vertex_offset = 0;
+				m_index_offset = vertex_size;
+				GPUBuffer::InitFromMemory(BufferType::LowDynamic, vertex_size + index_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, data, vertex_size + index_size, std::move(name), false);
+			}
 			void SetVertexData(CPUBuffer data);
 			void SetIndexData(CPUBuffer data);
 			inline void BindVertex(VkCommandBuffer cmd) const noexcept { RenderCore::Get().vkCmdBindVertexBuffers(cmd, 0, 1, &m_buffer, &m_vertex_offset); }
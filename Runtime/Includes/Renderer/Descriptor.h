@@ -1,8 +1,10 @@
 #ifndef __SCOP_DESCRIPTOR_SET__
 #define __SCOP_DESCRIPTOR_SET__
 
+#include <memory>
 #include <vector>
 #include <cstdint>
+#include <unordered_map>
 
 #include <kvf.h>
 #include <Utils/NonOwningPtr.h>
@@ -16,10 +18,26 @@ namespace Scop
 		NonOwningPtr<class GPUBuffer> storage_buffer_ptr;
 		NonOwningPtr<class GPUBuffer> uniform_buffer_ptr;
 		NonOwningPtr<class Image> image_ptr;
+		VkDeviceSize buffer_offset = 0;
+		VkDeviceSize buffer_range = VK_WHOLE_SIZE;
 		VkDescriptorType type;
 		std::uint32_t binding;
 	};
 
+	// What a write put in a binding, compared field by field so a skipped write never leaves a stale descriptor
+	struct WrittenDescriptor
+	{
+		VkImageView image_view = VK_NULL_HANDLE;
+		VkSampler sampler = VK_NULL_HANDLE;
+		VkImageLayout image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		std::uint64_t image_generation = 0; // Handles may be recycled by the driver once the image is destroyed
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceSize buffer_offset = 0;
+		VkDeviceSize buffer_range = 0;
+
+		bool operator==(const WrittenDescriptor&) const = default;
+	};
+
 	class DescriptorPool
 	{
 		public:
@@ -37,9 +55,9 @@ namespace Scop
 			~DescriptorPool() = default;
 
 		private:
-			std::vector<std::shared_ptr<class DescriptorSet>> m_free_sets;
+			std::unordered_map<std::size_t, std::vector<std::shared_ptr<class DescriptorSet>>> m_free_sets; // Keyed by layout hash
 			std::vector<std::shared_ptr<class DescriptorSet>> m_used_sets;
-			VkDescriptorPool m_pool;
+			VkDescriptorPool m_pool = VK_NULL_HANDLE;
 			std::size_t m_allocation_count = 0;
 	};
 
@@ -54,7 +72,56 @@ namespace Scop
 			~DescriptorPoolManager() = default;
 
 		private:
-			std::vector<DescriptorPool> m_pools;
+			std::vector<std::unique_ptr<DescriptorPool>> m_pools;
+	};
+
+	// Per frame in flight pools reset wholesale at frame begin, sets are never freed individually
+	class TransientDescriptorAllocator
+	{
+		public:
+			TransientDescriptorAllocator() = default;
+
+			void Destroy() noexcept;
+			void Reset(std::size_t frame_index) noexcept;
+			[[nodiscard]] VkDescriptorSet Allocate(std::size_t frame_index, VkDescriptorSetLayout layout);
+			// Incremented on each reset, sets allocated under an older epoch are gone
+			[[nodiscard]] inline std::uint64_t GetEpoch(std::size_t frame_index) const noexcept { return m_epochs[frame_index]; }
+
+			~TransientDescriptorAllocator() = default;
+
+		private:
+			[[nodiscard]] VkDescriptorPool CreatePool() const noexcept;
+
+		private:
+			std::array<std::vector<VkDescriptorPool>, MAX_FRAMES_IN_FLIGHT> m_pools;
+			std::array<std::size_t, MAX_FRAMES_IN_FLIGHT> m_current_pools{};
+			std::array<std::uint64_t, MAX_FRAMES_IN_FLIGHT> m_epochs{};
+	};
+
+	// Descriptor set rewritten every frame, a new set is taken from the transient allocator on each update
+	class TransientDescriptorSet
+	{
+		public:
+			TransientDescriptorSet() = default;
+
+			void Init(const ShaderSetLayout& layout, ShaderType shader_type);
+
+			void SetImage(std::uint32_t binding, class Image& image);
+			void SetStorageBuffer(std::uint32_t binding, class GPUBuffer& buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+			void SetUniformBuffer(std::uint32_t binding, class GPUBuffer& buffer);
+			void Update(std::size_t i, VkCommandBuffer cmd = VK_NULL_HANDLE);
+
+			[[nodiscard]] inline VkDescriptorSet GetSet(std::size_t i) const noexcept { return m_sets[i]; }
+			[[nodiscard]] inline bool IsInit() const noexcept { return m_set_layout != VK_NULL_HANDLE; }
+
+			~TransientDescriptorSet() = default;
+
+		private:
+			std::vector<Descriptor> m_descriptors;
+			std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_sets{};
+			std::array<std::uint64_t, MAX_FRAMES_IN_FLIGHT> m_epochs{};
+			std::array<std::vector<WrittenDescriptor>, MAX_FRAMES_IN_FLIGHT> m_written_descriptors;
+			VkDescriptorSetLayout m_set_layout = VK_NULL_HANDLE;
 	};
 
 	class DescriptorSet : public std::enable_shared_from_this<DescriptorSet>
@@ -63,7 +130,7 @@ namespace Scop
 
 		public:
 			void SetImage(std::size_t i, std::uint32_t binding, class Image& image);
-			void SetStorageBuffer(std::size_t i, std::uint32_t binding, class GPUBuffer& buffer);
+			void SetStorageBuffer(std::size_t i, std::uint32_t binding, class GPUBuffer& buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
 			void SetUniformBuffer(std::size_t i, std::uint32_t binding, class GPUBuffer& buffer);
 			void Update(std::size_t i, VkCommandBuffer cmd = VK_NULL_HANDLE) noexcept;
 
@@ -78,13 +145,16 @@ namespace Scop
 			~DescriptorSet() = default;
 
 		private:
-			DescriptorSet(DescriptorPool& pool, VkDescriptorSetLayout vulkan_layout, const ShaderSetLayout& layout, std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> vulkan_sets, ShaderType shader_type);
+			DescriptorSet(DescriptorPool& pool, VkDescriptorSetLayout vulkan_layout, const ShaderSetLayout& layout, std::size_t layout_hash, std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> vulkan_sets, ShaderType shader_type);
 
 		private:
 			ShaderSetLayout m_shader_layout;
 			std::vector<Descriptor> m_descriptors;
 			std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_sets;
+			std::array<std::vector<WrittenDescriptor>, MAX_FRAMES_IN_FLIGHT> m_written_descriptors; // Empty until first written
 			VkDescriptorSetLayout m_set_layout;
+			std::size_t m_layout_hash;
+			std::size_t m_pool_index; // Position in the used sets of the pool
 			ShaderType m_shader_type;
 			DescriptorPool& m_pool;
 	};
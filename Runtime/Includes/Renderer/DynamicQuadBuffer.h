@@ -0,0 +1,54 @@
+#ifndef __SCOP_DYNAMIC_QUAD_BUFFER__
+#define __SCOP_DYNAMIC_QUAD_BUFFER__
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <kvf.h>
+#include <Renderer/Buffer.h>
+#include <Renderer/Vertex.h>
+
+namespace Scop
+{
+	using Quad = std::array<Vertex, 4>;
+
+	// Persistently mapped quads with a region per frame in flight, drawn as two triangles each.
+	// A region only receives the quads that changed since it was last written
+	class DynamicQuadBuffer
+	{
+		public:
+			DynamicQuadBuffer() = default;
+
+			void Init(std::uint32_t capacity, std::string_view name = {});
+			void Destroy() noexcept;
+
+			// Grows the capacity when needed, the content of kept quads is preserved
+			void Resize(std::uint32_t count);
+			void SetQuad(std::uint32_t index, const Quad& quad) noexcept;
+			// Copies the dirty quads of a frame region, called once the frame fence has been waited
+			void Flush(std::size_t frame_index) noexcept;
+			void Bind(VkCommandBuffer cmd, std::size_t frame_index) const noexcept;
+			void Draw(VkCommandBuffer cmd, std::uint32_t first_quad, std::uint32_t quad_count, std::size_t& drawcalls, std::size_t& polygondrawn) const noexcept;
+
+			[[nodiscard]] inline std::uint32_t GetCount() const noexcept { return m_count; }
+			[[nodiscard]] inline std::uint32_t GetCapacity() const noexcept { return m_capacity; }
+
+			~DynamicQuadBuffer();
+
+		private:
+			void CreateBuffers();
+
+		private:
+			GPUBuffer m_vertex_buffer;
+			GPUBuffer m_index_buffer;
+			std::vector<Quad> m_shadow;
+			std::vector<std::uint8_t> m_dirty_frames; // One bit per frame in flight for each quad
+			std::string m_name;
+			std::uint32_t m_capacity = 0;
+			std::uint32_t m_count = 0;
+	};
+}
+
+#endif
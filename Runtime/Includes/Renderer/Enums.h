@@ -26,6 +26,16 @@ namespace Scop
 		EndEnum
 	};
 	constexpr std::size_t ImageTypeCount = static_cast<std::size_t>(ImageType::EndEnum);
+
+	enum class TextureMipmapMode
+	{
+		None = 0,
+		Generate, // full chain created at load time
+		Stream,   // coarse mips at load time, finer ones uploaded later under the streaming budget
+
+		EndEnum
+	};
+	constexpr std::size_t TextureMipmapModeCount = static_cast<std::size_t>(TextureMipmapMode::EndEnum);
 }
 
 #endif
@@ -1,8 +1,9 @@
 #ifndef __SCOP_IMAGE__
 #define __SCOP_IMAGE__
 
-#include <cstdint>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
 #include <kvf.h>
 
 #include <Maths/Vec4.h>
@@ -11,9 +12,14 @@
 #include <Utils/Buffer.h>
 #include <Renderer/Enums.h>
 #include <Renderer/Memory/Block.h>
+#include <Renderer/BindlessTextureTable.h>
+#include <Renderer/TextureCompression.h>
 
 namespace Scop
 {
+	// Single channel textures are broadcast to every component so shaders can sample them like RGBA ones
+	[[nodiscard]] VkComponentMapping GetTextureComponentMapping(VkFormat format) noexcept;
+
 	class Image
 	{
 		public:
@@ -26,6 +32,7 @@ namespace Scop
 				m_width = width;
 				m_height = height;
 				m_layout = layout;
+				m_generation = s_next_generation++;
 				#ifdef SCOP_HAS_DEBUG_UTILS_FUNCTIONS
 					VkDebugUtilsObjectNameInfoEXT name_info{};
 					name_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -36,15 +43,28 @@ namespace Scop
 				#endif
 			}
 
-			void Init(ImageType type, std::uint32_t width, std::uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, bool is_multisampled = false, std::string_view name = {}, bool dedicated_alloc = false);
-			void CreateImageView(VkImageViewType type, VkImageAspectFlags aspectFlags, int layer_count = 1) noexcept;
+			void Init(ImageType type, std::uint32_t width, std::uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, bool is_multisampled = false, std::string_view name = {}, bool dedicated_alloc = false, std::uint32_t mip_levels = 1);
+			void CreateImageView(VkImageViewType type, VkImageAspectFlags aspectFlags, int layer_count = 1, VkComponentMapping components = {}) noexcept;
 			void CreateSampler() noexcept;
 			void TransitionLayout(VkImageLayout new_layout, VkCommandBuffer cmd = VK_NULL_HANDLE);
 			void Clear(VkCommandBuffer cmd, Vec4f color);
 
+			// Uploads levels[first_level + i] into mip i, the image ends up in shader read only layout
+			void UploadMipLevels(const std::vector<CPUBuffer>& levels, std::uint32_t first_level = 0);
+			// Same with every level already packed in data, mip i starting at mip_offsets[i]
+			void UploadMipLevels(const CPUBuffer& data, const std::vector<std::size_t>& mip_offsets);
+			// Overwrites a rectangle of mip 0 with tightly packed pixels, the image ends up in shader read only layout
+			void UploadRegion(const CPUBuffer& pixels, std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height);
+			// Fills every mip from mip 0 with linear blits, all mips must be in transfer dst layout
+			void GenerateMipmaps(VkCommandBuffer cmd);
+			// Exchanges the Vulkan objects but keeps the size, used to swap the resident part of streamed textures
+			void SwapStorage(Image& image) noexcept;
+
 			void DestroySampler() noexcept;
 			void DestroyImageView() noexcept;
 			virtual void Destroy() noexcept;
+			// Caller must make sure the GPU is done with the image
+			void DestroyWithoutSync() noexcept;
 
 			[[nodiscard]] inline VkImage Get() const noexcept { return m_image; }
 			[[nodiscard]] inline VkImage operator()() const noexcept { return m_image; }
@@ -56,15 +76,22 @@ namespace Scop
 			[[nodiscard]] inline VkSampler GetSampler() const noexcept { return m_sampler; }
 			[[nodiscard]] inline std::uint32_t GetWidth() const noexcept { return m_width; }
 			[[nodiscard]] inline std::uint32_t GetHeight() const noexcept { return m_height; }
+			[[nodiscard]] inline std::uint32_t GetMipLevels() const noexcept { return m_mip_levels; }
 			[[nodiscard]] inline bool IsInit() const noexcept { return m_image != VK_NULL_HANDLE; }
 			[[nodiscard]] inline ImageType GetType() const noexcept { return m_type; }
+			// Changes each time the Vulkan objects behind this image are replaced, unlike its address
+			[[nodiscard]] inline std::uint64_t GetGeneration() const noexcept { return m_generation; }
 
 			[[nodiscard]] inline static std::size_t GetImageCount() noexcept { return s_image_count; }
 
 			virtual ~Image() = default;
 
+		protected:
+			inline void SetExtent(std::uint32_t width, std::uint32_t height) noexcept { m_width = width; m_height = height; }
+
 		private:
 			inline static std::size_t s_image_count = 0;
+			inline static std::uint64_t s_next_generation = 1;
 
 			MemoryBlock m_memory = NULL_MEMORY_BLOCK;
 			VkImage m_image = VK_NULL_HANDLE;
@@ -74,8 +101,10 @@ namespace Scop
 			VkImageTiling m_tiling;
 			VkImageLayout m_layout = VK_IMAGE_LAYOUT_UNDEFINED;
 			ImageType m_type;
+			std::uint64_t m_generation = 0;
 			std::uint32_t m_width = 0;
 			std::uint32_t m_height = 0;
+			std::uint32_t m_mip_levels = 1;
 			bool m_is_multisampled = false;
 	};
 
@@ -96,38 +125,40 @@ namespace Scop
 
 	class Texture : public Image
 	{
+		friend class TextureStreamer;
+
 		public:
 			Texture() = default;
-			Texture(CPUBuffer pixels, std::uint32_t width, std::uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB, bool is_multisampled = false, std::string_view name = {}, bool dedicated_alloc = false)
-			{
-				Init(std::move(pixels), width, height, format, is_multisampled, std::move(name), dedicated_alloc);
-			}
-			inline void Init(CPUBuffer pixels, std::uint32_t width, std::uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB, bool is_multisampled = false, std::string_view name = {}, bool dedicated_alloc = false)
+			Texture(CPUBuffer pixels, std::uint32_t width, std::uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB, bool is_multisampled = false, std::string_view name = {}, bool dedicated_alloc = false, TextureMipmapMode mipmaps = TextureMipmapMode::None)
 			{
-				Image::Init(ImageType::Color, width, height, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, is_multisampled, std::move(name), dedicated_alloc);
-				Image::CreateImageView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT);
-				Image::CreateSampler();
-				if(pixels)
-				{
-					TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-					GPUBuffer staging_buffer;
-					std::size_t size = width * height * kvfFormatSize(format);
-					staging_buffer.Init(BufferType::Staging, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, pixels);
-					VkCommandBuffer cmd = kvfCreateCommandBuffer(RenderCore::Get().GetDevice());
-					kvfBeginCommandBuffer(cmd, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-					kvfCopyBufferToImage(cmd, Image::Get(), staging_buffer.Get(), staging_buffer.GetOffset(), VK_IMAGE_ASPECT_COLOR_BIT, { width, height, 1 });
-					RenderCore::Get().vkEndCommandBuffer(cmd);
-					VkFence fence = kvfCreateFence(RenderCore::Get().GetDevice());
-					kvfSubmitSingleTimeCommandBuffer(RenderCore::Get().GetDevice(), cmd, KVF_GRAPHICS_QUEUE, fence);
-					kvfDestroyFence(RenderCore::Get().GetDevice(), fence);
-					staging_buffer.Destroy();
-				}
-				if(!pixels)
-					TransitionLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-				else
-					TransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+				Init(std::move(pixels), width, height, format, is_multisampled, std::move(name), dedicated_alloc, mipmaps);
 			}
+			void Init(CPUBuffer pixels, std::uint32_t width, std::uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB, bool is_multisampled = false, std::string_view name = {}, bool dedicated_alloc = false, TextureMipmapMode mipmaps = TextureMipmapMode::None);
+			// For precompiled mip chains (block compressed formats included), mip i starts at mip_offsets[i] in data.
+			// Returns false without creating anything when the device cannot sample the format
+			bool InitFromMipChain(CPUBuffer data, const std::vector<std::size_t>& mip_offsets, std::uint32_t width, std::uint32_t height, VkFormat format, std::string_view name = {}, bool streamed = false);
+
+			// Slot in the bindless texture table, BINDLESS_INVALID_INDEX when bindless is disabled or for render targets
+			[[nodiscard]] inline std::uint32_t GetBindlessIndex() const noexcept { return m_bindless_index; }
+			[[nodiscard]] inline bool IsStreamed() const noexcept { return m_is_streamed; }
+			[[nodiscard]] inline std::uint64_t GetLastUseFrame() const noexcept { return m_last_use_frame; }
+
+			// Feeds the streaming LRU, no-op for textures that are not streamed
+			void MarkUsed() noexcept;
+
+			void Destroy() noexcept override;
+
 			~Texture() override { Destroy(); }
+
+		private:
+			void UploadPixels(CPUBuffer pixels, bool generate_mipmaps);
+			void RegisterBindless();
+			void RefreshBindless();
+
+		private:
+			std::uint64_t m_last_use_frame = 0;
+			std::uint32_t m_bindless_index = BINDLESS_INVALID_INDEX;
+			bool m_is_streamed = false;
 	};
 
 	class CubeTexture : public Image
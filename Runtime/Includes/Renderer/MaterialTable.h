@@ -0,0 +1,58 @@
+#ifndef __SCOP_MATERIAL_TABLE__
+#define __SCOP_MATERIAL_TABLE__
+
+#include <vector>
+#include <cstdint>
+
+#include <kvf.h>
+#include <Renderer/Buffer.h>
+
+namespace Scop
+{
+	constexpr const std::uint32_t MATERIAL_TABLE_INVALID_SLOT = 0xFFFFFFFF;
+	constexpr const std::uint32_t MATERIAL_TABLE_INITIAL_CAPACITY = 1024;
+
+	// One host visible storage buffer holding every material, with a region per frame in flight.
+	// A slot is only copied to a frame region when its data changed since that region was last written
+	class MaterialTable
+	{
+		public:
+			MaterialTable() = default;
+
+			void Init(std::uint32_t slot_size, std::uint32_t capacity = MATERIAL_TABLE_INITIAL_CAPACITY);
+			void Destroy() noexcept;
+
+			[[nodiscard]] std::uint32_t Register();
+			void Release(std::uint32_t slot) noexcept;
+			void SetData(std::uint32_t slot, const void* data) noexcept;
+			void Flush(std::uint32_t slot, std::size_t frame_index) noexcept;
+
+			[[nodiscard]] inline GPUBuffer& GetBuffer() noexcept { return m_buffer; }
+			[[nodiscard]] inline VkDeviceSize GetSlotOffset(std::uint32_t slot, std::size_t frame_index) const noexcept { return (frame_index * m_capacity + slot) * m_stride; }
+			[[nodiscard]] inline VkDeviceSize GetSlotSize() const noexcept { return m_slot_size; }
+			[[nodiscard]] inline VkDeviceSize GetFrameRegionOffset(std::size_t frame_index) const noexcept { return frame_index * m_capacity * m_stride; }
+			[[nodiscard]] inline VkDeviceSize GetFrameRegionSize() const noexcept { return m_capacity * m_stride; }
+			// Index of the slot in a frame region seen as an array of slot sized elements, the stride is a multiple of the slot size
+			[[nodiscard]] inline std::uint32_t GetSlotElementIndex(std::uint32_t slot) const noexcept { return static_cast<std::uint32_t>(slot * (m_stride / m_slot_size)); }
+			[[nodiscard]] inline std::uint32_t GetCapacity() const noexcept { return m_capacity; }
+			[[nodiscard]] inline std::uint32_t GetUsedCount() const noexcept { return m_next_slot - static_cast<std::uint32_t>(m_free_slots.size()); }
+
+			~MaterialTable() = default;
+
+		private:
+			void CreateBuffer();
+			void Grow();
+
+		private:
+			GPUBuffer m_buffer;
+			std::vector<std::uint8_t> m_shadow; // CPU side copy of one frame region, used to fill the other ones lazily
+			std::vector<std::uint8_t> m_dirty_frames; // One bit per frame in flight for each slot
+			std::vector<std::uint32_t> m_free_slots;
+			VkDeviceSize m_slot_size = 0;
+			VkDeviceSize m_stride = 0;
+			std::uint32_t m_capacity = 0;
+			std::uint32_t m_next_slot = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef __SCOP_DESCRIPTOR_SET_LAYOUT_CACHE__
+#define __SCOP_DESCRIPTOR_SET_LAYOUT_CACHE__
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <kvf.h>
+
+#include <Renderer/Pipelines/Shader.h>
+
+namespace Scop
+{
+	// Order independent, two identical layouts always give the same hash
+	[[nodiscard]] std::size_t HashShaderSetLayout(const ShaderSetLayout& layout, VkShaderStageFlags stages) noexcept;
+
+	// Owns every VkDescriptorSetLayout so identical layouts are shared between shaders, pipelines and descriptor sets
+	class DescriptorSetLayoutCache
+	{
+		public:
+			DescriptorSetLayoutCache() = default;
+
+			[[nodiscard]] VkDescriptorSetLayout Get(const ShaderSetLayout& layout, VkShaderStageFlags stages);
+			void Destroy() noexcept;
+
+			[[nodiscard]] inline std::size_t GetSize() const noexcept { return m_layouts.size(); }
+
+			~DescriptorSetLayoutCache() = default;
+
+		private:
+			struct Entry
+			{
+				ShaderSetLayout layout;
+				VkShaderStageFlags stages;
+				VkDescriptorSetLayout vulkan_layout;
+			};
+
+		private:
+			std::unordered_multimap<std::size_t, Entry> m_layouts;
+	};
+}
+
+#endif
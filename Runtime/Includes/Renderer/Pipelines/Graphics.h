@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <vector>
+#include <future>
 
 #include <kvf.h>
 
@@ -36,6 +37,7 @@ namespace Scop
 		friend class ForwardPass;
 		friend class PostProcessPass;
 		friend class SkyboxPass;
+		friend class GraphicPipelineCache;
 
 		public:
 			GraphicPipeline() = default;
@@ -47,21 +49,38 @@ namespace Scop
 				m_description = std::move(descriptor);
 			}
 
+			// Returns true once the pipeline can be bound, polling the background compilation if any
+			[[nodiscard]] bool IsReady() noexcept;
 			bool BindPipeline(VkCommandBuffer command_buffer, std::size_t framebuffer_index, std::array<float, 4> clear) noexcept;
 			void EndPipeline(VkCommandBuffer command_buffer) noexcept override;
 			void Destroy() noexcept;
 
+			// Framebuffers are rebuilt on next bind, to be used when attachments are recreated with a new size
+			inline void InvalidateFramebuffers() noexcept { m_framebuffers_dirty = true; }
+
 			[[nodiscard]] inline VkPipeline GetPipeline() const override { return m_pipeline; }
 			[[nodiscard]] inline VkPipelineLayout GetPipelineLayout() const override { return m_pipeline_layout; }
 			[[nodiscard]] inline VkPipelineBindPoint GetPipelineBindPoint() const override { return VK_PIPELINE_BIND_POINT_GRAPHICS; }
 			[[nodiscard]] inline bool IsPipelineBound() const noexcept { return s_bound_pipeline == this; }
+			[[nodiscard]] inline bool IsCompiling() const noexcept { return m_pending_pipeline.valid(); }
+			[[nodiscard]] inline bool AreFramebuffersDirty() const noexcept { return m_framebuffers_dirty; }
+			// True when the fragment shader samples the bindless texture table instead of per material sets
+			[[nodiscard]] inline bool UsesBindlessTextures() const noexcept { return m_uses_bindless_textures; }
+			// Stages whose push constant ranges overlap the given bytes, as vkCmdPushConstants expects them
+			[[nodiscard]] VkShaderStageFlags GetPushConstantStages(std::uint32_t offset, std::uint32_t size) const noexcept;
+			// Generations of the color attachments then the depth one when the framebuffers were created
+			[[nodiscard]] inline const std::vector<std::uint64_t>& GetAttachmentGenerations() const noexcept { return m_attachment_generations; }
 			[[nodiscard]] inline GraphicPipelineDescriptor& GetDescription() noexcept { return m_description; }
 
 			inline ~GraphicPipeline() noexcept { Destroy(); }
 
 		private:
-			void Init(GraphicPipelineDescriptor descriptor);
-			void CreateFramebuffers(const std::vector<NonOwningPtr<Texture>>& render_targets, bool clear_attachments);
+			void Init(GraphicPipelineDescriptor descriptor, bool async = false);
+			void OnPipelineCreated();
+			[[nodiscard]] std::vector<VkDescriptorSetLayout> MergeSetLayouts() const;
+			void CreateRenderPass(bool clear_attachments);
+			void CreateFramebuffers();
+			void DestroyFramebuffers();
 			void TransitionAttachments(VkCommandBuffer cmd = VK_NULL_HANDLE);
 
 			// Private override to remove access
@@ -73,9 +92,14 @@ namespace Scop
 			GraphicPipelineDescriptor m_description;
 			std::vector<VkFramebuffer> m_framebuffers;
 			std::vector<VkClearValue> m_clears;
+			std::vector<std::uint64_t> m_attachment_generations;
+			std::vector<VkPushConstantRange> m_push_constants;
+			std::future<VkPipeline> m_pending_pipeline;
 			VkRenderPass m_renderpass = VK_NULL_HANDLE;
 			VkPipeline m_pipeline = VK_NULL_HANDLE;
 			VkPipelineLayout m_pipeline_layout = VK_NULL_HANDLE;
+			bool m_framebuffers_dirty = false;
+			bool m_uses_bindless_textures = false;
 	};
 }
 
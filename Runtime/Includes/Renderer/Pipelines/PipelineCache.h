@@ -0,0 +1,36 @@
+#ifndef __SCOP_GRAPHICS_PIPELINE_CACHE__
+#define __SCOP_GRAPHICS_PIPELINE_CACHE__
+
+#include <memory>
+#include <cstddef>
+#include <unordered_map>
+
+#include <Renderer/Pipelines/Graphics.h>
+
+namespace Scop
+{
+	[[nodiscard]] std::size_t HashGraphicPipelineDescriptor(const GraphicPipelineDescriptor& descriptor) noexcept;
+	[[nodiscard]] bool AreGraphicPipelineDescriptorsCompatible(const GraphicPipelineDescriptor& lhs, const GraphicPipelineDescriptor& rhs) noexcept;
+
+	class GraphicPipelineCache
+	{
+		public:
+			GraphicPipelineCache() = default;
+
+			// Returns a pipeline shared by every requester with a compatible descriptor, created on first request
+			[[nodiscard]] std::shared_ptr<GraphicPipeline> RequestPipeline(GraphicPipelineDescriptor descriptor, bool async = false);
+			void Destroy() noexcept;
+
+			[[nodiscard]] inline std::size_t GetSize() const noexcept { return m_pipelines.size(); }
+
+			~GraphicPipelineCache() = default;
+
+		private:
+			void CollectGarbage();
+
+		private:
+			std::unordered_multimap<std::size_t, std::weak_ptr<GraphicPipeline>> m_pipelines;
+	};
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __SCOP_PIPELINE_COMPILER__
+#define __SCOP_PIPELINE_COMPILER__
+
+#include <queue>
+#include <mutex>
+#include <future>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <condition_variable>
+
+#include <kvf.h>
+
+namespace Scop
+{
+	// Worker threads dedicated to vkCreateGraphicsPipelines calls
+	class PipelineCompiler
+	{
+		public:
+			PipelineCompiler() = default;
+
+			void Init(std::size_t workers_count = 0);
+			[[nodiscard]] std::future<VkPipeline> Submit(std::function<VkPipeline()> job);
+			void Destroy() noexcept;
+
+			[[nodiscard]] inline std::size_t GetWorkersCount() const noexcept { return m_workers.size(); }
+
+			~PipelineCompiler() = default;
+
+		private:
+			void WorkerLoop();
+
+		private:
+			std::vector<std::thread> m_workers;
+			std::queue<std::packaged_task<VkPipeline()>> m_jobs;
+			std::mutex m_mutex;
+			std::condition_variable m_condition;
+			bool m_stop = false;
+	};
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef __SCOP_SHADER__
 #define __SCOP_SHADER__
 
+#include <map>
+#include <span>
 #include <vector>
 #include <cstdint>
 #include <filesystem>
@@ -13,13 +15,22 @@
 
 namespace Scop
 {
+	constexpr const std::uint32_t SHADER_UNBOUNDED_DESCRIPTOR_COUNT = 0; // Runtime arrays, sized by whoever owns the set
+
 	struct ShaderSetLayout
 	{
 		std::unordered_map<int, VkDescriptorType> binds;
+		std::unordered_map<int, std::uint32_t> counts; // Array bindings only, others hold a single descriptor
+
+		ShaderSetLayout(std::unordered_map<int, VkDescriptorType> b, std::unordered_map<int, std::uint32_t> c = {}) : binds(std::move(b)), counts(std::move(c)) {}
 
-		ShaderSetLayout(std::unordered_map<int, VkDescriptorType> b) : binds(std::move(b)) {}
+		[[nodiscard]] inline std::uint32_t GetDescriptorCount(int binding) const
+		{
+			auto it = counts.find(binding);
+			return it != counts.end() ? it->second : 1;
+		}
 
-		inline bool operator==(const ShaderSetLayout& rhs) const { return binds == rhs.binds; }
+		inline bool operator==(const ShaderSetLayout& rhs) const { return binds == rhs.binds && counts == rhs.counts; }
 	};
 
 	struct ShaderPushConstantLayout
@@ -48,13 +59,15 @@ namespace Scop
 	struct ShaderPipelineLayoutPart
 	{
 		std::vector<VkPushConstantRange> push_constants;
-		std::vector<VkDescriptorSetLayout> set_layouts;
+		std::map<int, VkDescriptorSetLayout> set_layouts; // Owned by the descriptor set layout cache
 	};
 
 	class Shader
 	{
 		public:
-			Shader(const std::vector<std::uint32_t>& bytecode, ShaderType type, ShaderLayout layout, std::string shader_name = {});
+			Shader(std::vector<std::uint32_t> bytecode, ShaderType type, ShaderLayout layout, std::string shader_name = {});
+			// Builds the module straight from bytecode owned by someone else, GetByteCode() stays empty
+			Shader(std::span<const std::uint32_t> bytecode, ShaderType type, ShaderLayout layout, std::string shader_name = {});
 
 			[[nodiscard]] inline const ShaderLayout& GetShaderLayout() const { return m_layout; }
 			[[nodiscard]] inline const std::vector<std::uint32_t>& GetByteCode() const noexcept { return m_bytecode; }
@@ -70,6 +83,7 @@ namespace Scop
 			~Shader();
 
 		private:
+			void CreateModule(std::span<const std::uint32_t> bytecode, ShaderType type);
 			void GeneratePipelineLayout(ShaderLayout layout);
 
 		private:
@@ -77,13 +91,15 @@ namespace Scop
 			ShaderLayout m_layout;
 			ShaderPipelineLayoutPart m_pipeline_layout_part;
 			std::vector<std::uint32_t> m_bytecode;
-			std::vector<VkDescriptorSetLayout> m_set_layouts;
 			VkShaderStageFlagBits m_stage;
 			VkShaderModule m_module = VK_NULL_HANDLE;
 			NonOwningPtr<class GraphicPipeline> p_pipeline_in_use = nullptr;
 	};
 
 	std::shared_ptr<Shader> LoadShaderFromFile(const std::filesystem::path& filepath, ShaderType type, ShaderLayout layout);
+	// Layout is reflected from the SPIR-V bytecode
+	std::shared_ptr<Shader> LoadShaderFromFile(const std::filesystem::path& filepath, ShaderType type);
+	std::shared_ptr<Shader> LoadShaderFromArchive(const class ShaderArchive& archive, const std::string& name, ShaderType type);
 
 	static const ShaderLayout DefaultForwardVertexShaderLayout(
 		{
@@ -101,7 +117,7 @@ namespace Scop
 			{ 1,
 				Scop::ShaderSetLayout({ 
 					{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER },
-					{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }
+					{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER }
 				})
 			}
 		}, {}
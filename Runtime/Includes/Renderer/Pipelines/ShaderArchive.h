@@ -0,0 +1,46 @@
+#ifndef __SCOP_SHADER_ARCHIVE__
+#define __SCOP_SHADER_ARCHIVE__
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+
+namespace Scop
+{
+	// Single file holding every compiled shader: header, index, then the concatenated SPIR-V
+	class ShaderArchive
+	{
+		public:
+			ShaderArchive() = default;
+
+			// Packs every .spv file of a directory, indexed by file stem
+			static bool Pack(const std::filesystem::path& directory, const std::filesystem::path& archive_path);
+			// True if the archive is missing or older than one of the .spv files of the directory
+			[[nodiscard]] static bool IsOutdated(const std::filesystem::path& directory, const std::filesystem::path& archive_path);
+
+			bool Open(const std::filesystem::path& filepath);
+			void Close() noexcept;
+
+			[[nodiscard]] std::span<const std::uint32_t> GetBytecode(const std::string& name) const;
+			[[nodiscard]] inline bool Contains(const std::string& name) const { return m_entries.contains(name); }
+			[[nodiscard]] inline bool IsOpen() const noexcept { return !m_data.empty(); }
+
+			~ShaderArchive() = default;
+
+		private:
+			struct Entry
+			{
+				std::size_t offset; // in words
+				std::size_t words_count;
+			};
+
+		private:
+			std::unordered_map<std::string, Entry> m_entries;
+			std::vector<std::uint32_t> m_data;
+	};
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __SCOP_SHADER_REFLECTION__
+#define __SCOP_SHADER_REFLECTION__
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+#include <Renderer/Pipelines/Shader.h>
+
+namespace Scop
+{
+	// Extracts descriptor sets, bindings and push constant ranges from SPIR-V bytecode, nullopt if the bytecode is invalid
+	[[nodiscard]] std::optional<ShaderLayout> ReflectShaderLayout(const std::uint32_t* bytecode, std::size_t words_count);
+	[[nodiscard]] inline std::optional<ShaderLayout> ReflectShaderLayout(const std::vector<std::uint32_t>& bytecode) { return ReflectShaderLayout(bytecode.data(), bytecode.size()); }
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define __SCOP_RENDER_CORE__
 
 #include <array>
+#include <string>
 #include <memory>
 #include <cstdint>
 #include <optional>
@@ -18,6 +19,8 @@ namespace Scop
 	constexpr const int DEFAULT_FRAGMENT_SHADER_ID = 1;
 	constexpr const int BASIC_FRAGMENT_SHADER_ID = 2;
 
+	enum class ShaderType;
+
 	std::optional<std::uint32_t> FindMemoryType(std::uint32_t type_filter, VkMemoryPropertyFlags properties, bool error = true);
 
 	#if defined(DEBUG) && defined(VK_EXT_debug_utils)
@@ -33,14 +36,27 @@ namespace Scop
 			[[nodiscard]] inline VkInstance& GetInstanceRef() noexcept { return m_instance; }
 			[[nodiscard]] inline VkDevice GetDevice() const noexcept { return m_device; }
 			[[nodiscard]] inline VkPhysicalDevice GetPhysicalDevice() const noexcept { return m_physical_device; }
+			[[nodiscard]] inline VkPipelineCache GetPipelineCache() const noexcept { return m_pipeline_cache; }
 			[[nodiscard]] inline DeviceAllocator& GetAllocator() noexcept { return m_allocator; }
 			[[nodiscard]] inline bool StackSubmits() const noexcept { return m_stack_submits; }
+			[[nodiscard]] inline bool IsBindlessEnabled() const noexcept { return m_bindless_enabled; }
+			[[nodiscard]] inline class BindlessTextureTable& GetBindlessTextureTable() noexcept { return *p_bindless_texture_table; }
+			[[nodiscard]] inline class MaterialTable& GetMaterialTable() noexcept { return *p_material_table; }
+			[[nodiscard]] inline class TextureStreamer& GetTextureStreamer() noexcept { return *p_texture_streamer; }
+			[[nodiscard]] inline class GlyphCache& GetGlyphCache() noexcept { return *p_glyph_cache; }
+			[[nodiscard]] inline class DescriptorSetLayoutCache& GetDescriptorSetLayoutCache() noexcept { return *p_descriptor_set_layout_cache; }
 			[[nodiscard]] inline class DescriptorPoolManager& GetDescriptorPoolManager() noexcept { return *p_descriptor_pool_manager; }
+			[[nodiscard]] inline class TransientDescriptorAllocator& GetTransientDescriptorAllocator() noexcept { return *p_transient_descriptor_allocator; }
+			[[nodiscard]] inline class GraphicPipelineCache& GetGraphicPipelineCache() noexcept { return *p_graphic_pipeline_cache; }
+			[[nodiscard]] inline class PipelineCompiler& GetPipelineCompiler() noexcept { return *p_pipeline_compiler; }
 
 			[[nodiscard]] inline std::shared_ptr<class Shader> GetDefaultVertexShader() const { return m_internal_shaders[DEFAULT_VERTEX_SHADER_ID]; }
 			[[nodiscard]] inline std::shared_ptr<class Shader> GetBasicFragmentShader() const { return m_internal_shaders[BASIC_FRAGMENT_SHADER_ID]; }
 			[[nodiscard]] inline std::shared_ptr<class Shader> GetDefaultFragmentShader() const { return m_internal_shaders[DEFAULT_FRAGMENT_SHADER_ID]; }
 
+			// Loads an engine shader from the shader archive, or from its own spirv file if it is not packed
+			[[nodiscard]] std::shared_ptr<class Shader> LoadInternalShader(const std::string& name, ShaderType type) const;
+
 			inline void WaitDeviceIdle() const noexcept { vkDeviceWaitIdle(m_device); }
 			inline void WaitQueueIdle(KvfQueueType queue) const noexcept { vkQueueWaitIdle(kvfGetDeviceQueue(m_device, queue)); }
 
@@ -63,6 +79,10 @@ namespace Scop
 			void LoadKVFGlobalVulkanFunctionPointers() const noexcept;
 			void LoadKVFInstanceVulkanFunctionPointers() const noexcept;
 			void LoadKVFDeviceVulkanFunctionPointers() const noexcept;
+			void CreatePipelineCache();
+			void SavePipelineCache() const;
+			void OpenShaderArchive();
+			[[nodiscard]] bool IsBindlessSupported() const;
 
 		private:
 			static RenderCore* s_instance;
@@ -72,8 +92,19 @@ namespace Scop
 			VkInstance m_instance = VK_NULL_HANDLE;
 			VkDevice m_device = VK_NULL_HANDLE;
 			VkPhysicalDevice m_physical_device = VK_NULL_HANDLE;
+			VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
+			std::unique_ptr<class ShaderArchive> p_shader_archive;
+			std::unique_ptr<class DescriptorSetLayoutCache> p_descriptor_set_layout_cache;
 			std::unique_ptr<class DescriptorPoolManager> p_descriptor_pool_manager;
+			std::unique_ptr<class TransientDescriptorAllocator> p_transient_descriptor_allocator;
+			std::unique_ptr<class GraphicPipelineCache> p_graphic_pipeline_cache;
+			std::unique_ptr<class PipelineCompiler> p_pipeline_compiler;
+			std::unique_ptr<class BindlessTextureTable> p_bindless_texture_table;
+			std::unique_ptr<class MaterialTable> p_material_table;
+			std::unique_ptr<class TextureStreamer> p_texture_streamer;
+			std::unique_ptr<class GlyphCache> p_glyph_cache;
 			bool m_stack_submits = false;
+			bool m_bindless_enabled = false;
 	};
 }
 
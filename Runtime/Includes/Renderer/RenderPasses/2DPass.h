@@ -1,11 +1,15 @@
 #ifndef __SCOP_2D_PASS__
 #define __SCOP_2D_PASS__
 
+#include <array>
 #include <memory>
+#include <vector>
 
 #include <Renderer/Descriptor.h>
 #include <Renderer/Pipelines/Shader.h>
 #include <Renderer/Pipelines/Graphics.h>
+#include <Renderer/DynamicQuadBuffer.h>
+#include <Graphics/GlyphCache.h>
 
 namespace Scop
 {
@@ -14,11 +18,38 @@ namespace Scop
 		public:
 			Render2DPass() = default;
 			void Init();
+			void Prewarm(class Scene& scene, class Texture& render_target);
 			void Pass(class Scene& scene, class Renderer& renderer, class Texture& render_target);
 			void Destroy();
 			~Render2DPass() = default;
 
 		private:
+			// Sprites sharing a texture or text glyphs sharing a glyph cache page, drawn with a single call
+			struct SpriteBatch
+			{
+				const class Sprite* first; // Null for glyph batches
+				std::uint32_t glyph_page;
+				std::uint32_t first_quad;
+				std::uint32_t quad_count;
+			};
+
+			struct TextPage
+			{
+				const class Text* text;
+				std::size_t page;
+			};
+
+		private:
+			void RequestPipeline(class Scene& scene, class Texture& render_target);
+			void BuildSpriteBatches(class Scene& scene);
+			void BindGlyphPage(std::uint32_t glyph_page, std::size_t frame_index, VkCommandBuffer cmd);
+
+		private:
+			DynamicQuadBuffer m_sprite_quads;
+			std::vector<const class Sprite*> m_sorted_sprites;
+			std::vector<TextPage> m_sorted_text_pages;
+			std::array<std::shared_ptr<DescriptorSet>, GLYPH_CACHE_MAX_PAGES> m_glyph_page_sets;
+			std::vector<SpriteBatch> m_sprite_batches;
 			GraphicPipeline m_pipeline;
 			std::shared_ptr<DescriptorSet> p_viewer_data_set;
 			std::shared_ptr<UniformBuffer> p_viewer_data_buffer;
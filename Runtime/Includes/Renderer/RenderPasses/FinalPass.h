@@ -20,7 +20,7 @@ namespace Scop
 
 		private:
 			GraphicPipeline m_pipeline;
-			std::shared_ptr<DescriptorSet> p_set;
+			TransientDescriptorSet m_set;
 			std::shared_ptr<Shader> p_vertex_shader;
 			std::shared_ptr<Shader> p_fragment_shader;
 	};
@@ -7,8 +7,13 @@ namespace Scop
 	{
 		public:
 			ForwardPass() = default;
+			void Prewarm(class Scene& scene, class Texture& render_target);
 			void Pass(class Scene& scene, class Renderer& renderer, class Texture& render_target);
 			~ForwardPass() = default;
+
+		private:
+			void RequestScenePipeline(class Scene& scene, class Texture& render_target);
+			void RequestActorPipeline(class Scene& scene, class Actor& actor, class Texture& render_target);
 	};
 }
 
@@ -15,10 +15,14 @@ namespace Scop
 		public:
 			RenderPasses() = default;
 			void Init();
+			void Prewarm(class Scene& scene, class Renderer& renderer);
 			void Pass(class Scene& scene, class Renderer& renderer);
 			void Destroy();
 			~RenderPasses() = default;
 
+		private:
+			void CreateMainRenderTexture(class Renderer& renderer);
+
 		private:
 			SkyboxPass m_skybox;
 			Render2DPass m_2Dpass;
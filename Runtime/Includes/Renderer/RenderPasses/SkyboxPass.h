@@ -14,13 +14,17 @@ namespace Scop
 		public:
 			SkyboxPass() = default;
 			void Init();
+			void Prewarm(class Scene& scene, class Texture& render_target);
 			void Pass(class Scene& scene, class Renderer& renderer, class Texture& render_target);
 			void Destroy();
 			~SkyboxPass() = default;
 
+		private:
+			void RequestPipeline(class Scene& scene, class Texture& render_target);
+
 		private:
 			GraphicPipeline m_pipeline;
-			std::shared_ptr<DescriptorSet> p_set;
+			TransientDescriptorSet m_set;
 			std::shared_ptr<Shader> p_vertex_shader;
 			std::shared_ptr<Shader> p_fragment_shader;
 			std::shared_ptr<class Mesh> m_cube;
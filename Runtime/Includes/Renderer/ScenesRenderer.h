@@ -10,6 +10,7 @@ namespace Scop
 		public:
 			SceneRenderer() = default;
 			void Init();
+			void Prewarm(class Scene& scene, class Renderer& renderer);
 			void Render(class Scene& scene, class Renderer& renderer); // TODO : add RTT support
 			void Destroy();
 			~SceneRenderer() = default;
@@ -0,0 +1,41 @@
+#ifndef __SCOP_TEXTURE_COMPRESSION__
+#define __SCOP_TEXTURE_COMPRESSION__
+
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <kvf.h>
+#include <Utils/Buffer.h>
+
+// CPU side texture processing, kept free of any Vulkan call so offline tools can link it without a device
+
+namespace Scop
+{
+	[[nodiscard]] inline std::uint32_t ComputeMipLevelsCount(std::uint32_t width, std::uint32_t height) noexcept
+	{
+		return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+	}
+
+	// CPU box filter for 8 bits four channels formats, returns every level starting with a copy of the given pixels
+	[[nodiscard]] std::vector<CPUBuffer> GenerateMipChain(const CPUBuffer& pixels, std::uint32_t width, std::uint32_t height);
+
+	// Bytes per 4x4 block, 0 for formats that are not block compressed
+	[[nodiscard]] std::uint32_t GetFormatBlockSize(VkFormat format) noexcept;
+
+	[[nodiscard]] inline bool IsBlockCompressedFormat(VkFormat format) noexcept
+	{
+		return GetFormatBlockSize(format) != 0;
+	}
+
+	[[nodiscard]] inline std::size_t ComputeCompressedLevelSize(VkFormat format, std::uint32_t width, std::uint32_t height) noexcept
+	{
+		return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * GetFormatBlockSize(format);
+	}
+
+	// Encodes 8 bits RGBA pixels into BC1 (opaque), BC3 or BC7 (mode 6 only), returns an empty buffer for other formats
+	[[nodiscard]] CPUBuffer CompressTexture(const CPUBuffer& pixels, std::uint32_t width, std::uint32_t height, VkFormat format);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef __SCOP_TEXTURE_STREAMER__
+#define __SCOP_TEXTURE_STREAMER__
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include <kvf.h>
+#include <Utils/Buffer.h>
+#include <Renderer/Image.h>
+#include <Renderer/Buffer.h>
+
+namespace Scop
+{
+	constexpr const std::size_t DEFAULT_TEXTURE_STREAMING_BUDGET = 256 * 1024 * 1024;
+	constexpr const std::uint32_t STREAMING_COARSE_MIP_SIZE = 64; // Mips up to this size are uploaded at load time and never evicted
+
+	// Keeps streamed textures as a resident tail of their mip chain. Each frame the most recently used texture
+	// missing detail gets one finer mip, least recently used textures drop their finest mip to stay under the budget
+	class TextureStreamer
+	{
+		public:
+			TextureStreamer() = default;
+
+			void Init(std::size_t budget = DEFAULT_TEXTURE_STREAMING_BUDGET) noexcept;
+			void Destroy() noexcept;
+
+			void Register(Texture& texture, std::vector<CPUBuffer> mips, VkFormat format);
+			void Unregister(Texture& texture) noexcept;
+
+			// Called once per frame after the frame fence has been waited, uploads are recorded in the frame command buffer
+			void Update(VkCommandBuffer cmd);
+
+			inline void SetBudget(std::size_t budget) noexcept { m_budget = budget; }
+
+			[[nodiscard]] inline std::size_t GetBudget() const noexcept { return m_budget; }
+			[[nodiscard]] inline std::size_t GetResidentSize() const noexcept { return m_resident_size; }
+			[[nodiscard]] inline std::uint64_t GetCurrentFrame() const noexcept { return m_frame; }
+
+			~TextureStreamer() = default;
+
+		private:
+			struct Entry
+			{
+				std::vector<CPUBuffer> mips;
+				VkFormat format;
+				std::uint32_t width;
+				std::uint32_t height;
+				std::uint32_t resident_level; // Finest mip on the GPU
+				std::uint32_t coarse_level;
+			};
+
+			[[nodiscard]] std::size_t GetResidentSize(const Entry& entry, std::uint32_t level) const noexcept;
+			// Without a command buffer the mips are uploaded right away, for textures being loaded
+			void MakeResident(Texture& texture, Entry& entry, std::uint32_t level, VkCommandBuffer cmd = VK_NULL_HANDLE);
+			void RecordMipsTransfer(Texture& texture, const Entry& entry, Image& image, std::uint32_t level, VkCommandBuffer cmd);
+
+		private:
+			std::unordered_map<Texture*, Entry> m_entries;
+			std::vector<std::pair<Image, std::uint64_t>> m_retired_images; // Destroyed once no frame in flight can use them
+			std::vector<std::pair<GPUBuffer, std::uint64_t>> m_retired_staging_buffers;
+			std::size_t m_budget = DEFAULT_TEXTURE_STREAMING_BUDGET;
+			std::size_t m_resident_size = 0;
+			std::uint64_t m_frame = 0;
+	};
+}
+
+#endif
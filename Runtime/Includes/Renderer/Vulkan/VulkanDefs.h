@@ -40,6 +40,7 @@
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdBindIndexBuffer)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdBindPipeline)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdBindVertexBuffers)
+		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdBlitImage)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdClearAttachments)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdClearColorImage)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCmdClearDepthStencilImage)
@@ -63,6 +64,7 @@
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCreateGraphicsPipelines)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCreateImage)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCreateImageView)
+		SCOP_VULKAN_DEVICE_FUNCTION(vkCreatePipelineCache)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCreatePipelineLayout)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCreateRenderPass)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkCreateSampler)
@@ -78,6 +80,7 @@
 		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroyImage)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroyImageView)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroyPipeline)
+		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroyPipelineCache)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroyPipelineLayout)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroyRenderPass)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkDestroySampler)
@@ -94,6 +97,7 @@
 		SCOP_VULKAN_DEVICE_FUNCTION(vkGetFenceStatus)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkGetImageMemoryRequirements)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkGetImageSubresourceLayout)
+		SCOP_VULKAN_DEVICE_FUNCTION(vkGetPipelineCacheData)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkInvalidateMappedMemoryRanges)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkMapMemory)
 		SCOP_VULKAN_DEVICE_FUNCTION(vkQueueSubmit)
@@ -116,6 +120,11 @@
 		SCOP_VULKAN_DEVICE_FUNCTION(vkQueuePresentKHR)
 	#endif
 #endif
+#ifdef VK_KHR_get_physical_device_properties2
+	#ifdef SCOP_VULKAN_INSTANCE_FUNCTION
+		SCOP_VULKAN_INSTANCE_FUNCTION(vkGetPhysicalDeviceFeatures2KHR)
+	#endif
+#endif
 #ifdef VK_KHR_surface
 	#ifdef SCOP_VULKAN_INSTANCE_FUNCTION
 		SCOP_VULKAN_INSTANCE_FUNCTION(vkDestroySurfaceKHR)
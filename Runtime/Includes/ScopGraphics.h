@@ -11,6 +11,7 @@
 #include <Graphics/Cameras/FirstPerson3D.h>
 #include <Graphics/Loaders/OBJ.h>
 #include <Graphics/Loaders/BMP.h>
+#include <Graphics/Loaders/Texture.h>
 #include <Graphics/Narrator.h>
 
 #endif
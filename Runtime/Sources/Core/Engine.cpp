@@ -75,6 +75,7 @@ namespace Scop
 		Verify(p_current_scene, "no main scene registered");
 		float old_timestep = static_cast<float>(SDL_GetTicks64()) / 1000.0f;
 		p_current_scene->Init(&m_renderer);
+		m_scene_renderer.Prewarm(*p_current_scene, m_renderer);
 		while(m_running)
 		{
 			float current_timestep = (static_cast<float>(SDL_GetTicks64()) / 1000.0f) - old_timestep;
@@ -88,6 +89,7 @@ namespace Scop
 			{
 				RenderCore::Get().WaitDeviceIdle();
 				EventBus::SendBroadcast(Internal::SceneChangedEvent{});
+				m_scene_renderer.Prewarm(*p_current_scene, m_renderer);
 				m_scene_changed = false;
 				continue;
 			}
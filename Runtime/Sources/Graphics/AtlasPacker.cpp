@@ -0,0 +1,46 @@
+#include <Graphics/AtlasPacker.h>
+#include <Core/Logs.h>
+
+#define STBRP_ASSERT(x) Scop::Assert(x, "internal stb assertion " #x)
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <stb_rect_pack.h>
+
+namespace Scop
+{
+	bool PackAtlasRects(const std::vector<Vec2ui>& sizes, std::uint32_t page_size, std::vector<AtlasRect>& rects, std::uint32_t& page_count)
+	{
+		rects.assign(sizes.size(), AtlasRect{ 0, 0, 0 });
+		page_count = 0;
+
+		std::vector<stbrp_rect> pending(sizes.size());
+		for(std::size_t i = 0; i < sizes.size(); i++)
+		{
+			if(sizes[i].x > page_size || sizes[i].y > page_size)
+				return false;
+			pending[i].id = static_cast<int>(i);
+			pending[i].w = static_cast<int>(sizes[i].x);
+			pending[i].h = static_cast<int>(sizes[i].y);
+		}
+
+		std::vector<stbrp_node> nodes(page_size);
+		while(!pending.empty())
+		{
+			stbrp_context context;
+			stbrp_init_target(&context, static_cast<int>(page_size), static_cast<int>(page_size), nodes.data(), static_cast<int>(nodes.size()));
+			stbrp_pack_rects(&context, pending.data(), static_cast<int>(pending.size()));
+
+			// Rectangles that did not fit are moved to the next page
+			std::size_t remaining = 0;
+			for(stbrp_rect& rect : pending)
+			{
+				if(rect.was_packed)
+					rects[rect.id] = AtlasRect{ page_count, static_cast<std::uint32_t>(rect.x), static_cast<std::uint32_t>(rect.y) };
+				else
+					pending[remaining++] = rect;
+			}
+			pending.resize(remaining);
+			page_count++;
+		}
+		return true;
+	}
+}
@@ -3,8 +3,6 @@
 
 #include <fstream>
 
-#define STBRP_ASSERT(x) Scop::Assert(x, "internal stb assertion " #x)
-#define STB_RECT_PACK_IMPLEMENTATION
 #include <stb_rect_pack.h>
 
 #define STB_TRUETYPE_IMPLEMENTATION
@@ -14,7 +12,8 @@ namespace Scop
 {
 	void Font::BuildFont()
 	{
-		std::vector<std::uint8_t> file_bytes;
+		if(m_is_built)
+			return;
 		if(std::holds_alternative<std::filesystem::path>(m_build_data))
 		{
 			std::ifstream file(std::get<std::filesystem::path>(m_build_data), std::ios::binary);
@@ -24,42 +23,35 @@ namespace Scop
 				return;
 			}
 			std::ifstream::pos_type file_size = std::filesystem::file_size(std::get<std::filesystem::path>(m_build_data));
+			std::vector<std::uint8_t> file_bytes(file_size);
 			file.seekg(0, std::ios::beg);
-			file_bytes.resize(file_size);
 			file.read(reinterpret_cast<char*>(file_bytes.data()), file_size);
 			file.close();
+			m_build_data = std::move(file_bytes);
 		}
 
-		CPUBuffer bitmap(RANGE * RANGE);
-
-		stbtt_pack_context pc;
-		stbtt_PackBegin(&pc, bitmap.GetData(), RANGE, RANGE, RANGE, 1, nullptr);
-		if(std::holds_alternative<std::filesystem::path>(m_build_data))
-			stbtt_PackFontRange(&pc, file_bytes.data(), 0, m_scale, 32, 96, m_cdata.data());
-		else
-			stbtt_PackFontRange(&pc, std::get<std::vector<std::uint8_t>>(m_build_data).data(), 0, m_scale, 32, 96, m_cdata.data());
-		stbtt_PackEnd(&pc);
-
-		// TODO : find better solution; No, using VK_FORMAT_R8_SRGB does not work
-		CPUBuffer vulkan_bitmap(RANGE * RANGE * 4);
-		for(int i = 0, j = 0; i < RANGE * RANGE; i++, j += 4)
+		const std::vector<std::uint8_t>& ttf_data = std::get<std::vector<std::uint8_t>>(m_build_data);
+		if(!stbtt_InitFont(&m_info, ttf_data.data(), stbtt_GetFontOffsetForIndex(ttf_data.data(), 0)))
 		{
-			vulkan_bitmap.GetData()[j + 0] = bitmap.GetData()[i];
-			vulkan_bitmap.GetData()[j + 1] = bitmap.GetData()[i];
-			vulkan_bitmap.GetData()[j + 2] = bitmap.GetData()[i];
-			vulkan_bitmap.GetData()[j + 3] = bitmap.GetData()[i];
+			Error("Font: invalid font file, %", m_name);
+			return;
 		}
-
-		m_atlas.Init(std::move(vulkan_bitmap), RANGE, RANGE, VK_FORMAT_R8G8B8A8_SRGB, false, m_name + "_font_atlas_" + std::to_string(m_scale));
+		m_id = std::hash<std::string>{}(m_name);
+		m_is_built = true;
 
 		Message("Font: loaded % with a scale of %", m_name, m_scale);
 	}
 
+	float Font::GetKerning(std::uint32_t left, std::uint32_t right) const noexcept
+	{
+		return stbtt_GetCodepointKernAdvance(&m_info, static_cast<int>(left), static_cast<int>(right)) * stbtt_ScaleForPixelHeight(&m_info, static_cast<float>(GetSizeBucket()));
+	}
+
 	void Font::Destroy()
 	{
-		if(!m_atlas.IsInit())
+		if(!m_is_built)
 			return;
-		m_atlas.Destroy();
+		m_is_built = false;
 		Message("Font: unloaded % with a scale of %", m_name, m_scale);
 	}
 }
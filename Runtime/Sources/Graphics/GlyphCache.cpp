@@ -0,0 +1,192 @@
+#include <cstring>
+
+#include <Graphics/GlyphCache.h>
+#include <Graphics/Font.h>
+#include <Renderer/RenderCore.h>
+#include <Core/Logs.h>
+
+namespace Scop
+{
+	std::size_t GlyphCache::KeyHasher::operator()(const Key& key) const noexcept
+	{
+		std::size_t hash = std::hash<std::uint64_t>{}(key.font);
+		hash ^= std::hash<std::uint64_t>{}((static_cast<std::uint64_t>(key.codepoint) << 32) | key.size) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+
+	void GlyphCache::Init() noexcept
+	{
+		Message("Graphics: glyph cache created (% pages of %x% at most)", GLYPH_CACHE_MAX_PAGES, GLYPH_CACHE_PAGE_SIZE, GLYPH_CACHE_PAGE_SIZE);
+	}
+
+	const Glyph* GlyphCache::GetGlyph(const Font& font, std::uint32_t codepoint)
+	{
+		std::uint32_t size = font.GetSizeBucket();
+		Key key{ font.GetID(), codepoint, size };
+		if(auto it = m_glyphs.find(key); it != m_glyphs.end())
+		{
+			if(it->second.page != GLYPH_CACHE_NO_PAGE)
+				MarkPageUsed(it->second.page);
+			return &it->second;
+		}
+
+		const stbtt_fontinfo& info = font.GetFontInfo();
+		float scale = stbtt_ScaleForPixelHeight(&info, static_cast<float>(size));
+		int glyph_index = stbtt_FindGlyphIndex(&info, static_cast<int>(codepoint)); // Missing glyphs fall back on the .notdef glyph
+		int advance;
+		int left_side_bearing;
+		stbtt_GetGlyphHMetrics(&info, glyph_index, &advance, &left_side_bearing);
+		int x0, y0, x1, y1;
+		stbtt_GetGlyphBitmapBox(&info, glyph_index, scale, scale, &x0, &y0, &x1, &y1);
+
+		Glyph glyph;
+		glyph.advance = advance * scale;
+		glyph.offset = Vec2f{ static_cast<float>(x0), static_cast<float>(y0) };
+		glyph.size = Vec2f{ static_cast<float>(x1 - x0), static_cast<float>(y1 - y0) };
+		std::uint32_t width = static_cast<std::uint32_t>(x1 - x0);
+		std::uint32_t height = static_cast<std::uint32_t>(y1 - y0);
+		if(width == 0 || height == 0)
+			return &m_glyphs.emplace(key, glyph).first->second;
+
+		// Could never fit in a page, looking for space would only add and evict pages for nothing
+		if(width + GLYPH_PADDING > GLYPH_CACHE_PAGE_SIZE || height + GLYPH_PADDING > GLYPH_CACHE_PAGE_SIZE)
+		{
+			if(!m_warned_oversized)
+				Error("Graphics: glyphs larger than the %x% glyph cache pages cannot be drawn (%x% at size %)", GLYPH_CACHE_PAGE_SIZE, GLYPH_CACHE_PAGE_SIZE, width, height, size);
+			m_warned_oversized = true;
+			return &m_glyphs.emplace(key, glyph).first->second; // Kept without pixels so the pen still advances
+		}
+
+		std::uint32_t page_index, x, y;
+		if(!FindSpace(width + GLYPH_PADDING, height + GLYPH_PADDING, page_index, x, y))
+		{
+			if(!m_warned_full)
+				Warning("Graphics: glyph cache is full, some glyphs will not be drawn");
+			m_warned_full = true;
+			return nullptr;
+		}
+
+		Page& page = *m_pages[page_index];
+		stbtt_MakeGlyphBitmap(&info, page.pixels.GetData() + y * GLYPH_CACHE_PAGE_SIZE + x, width, height, GLYPH_CACHE_PAGE_SIZE, scale, scale, glyph_index);
+		page.dirty_min_x = std::min(page.dirty_min_x, x);
+		page.dirty_min_y = std::min(page.dirty_min_y, y);
+		page.dirty_max_x = std::max(page.dirty_max_x, x + width);
+		page.dirty_max_y = std::max(page.dirty_max_y, y + height);
+		MarkPageUsed(page_index);
+
+		glyph.page = page_index;
+		glyph.uv_min = Vec2f{ static_cast<float>(x), static_cast<float>(y) } / static_cast<float>(GLYPH_CACHE_PAGE_SIZE);
+		glyph.uv_max = Vec2f{ static_cast<float>(x + width), static_cast<float>(y + height) } / static_cast<float>(GLYPH_CACHE_PAGE_SIZE);
+		return &m_glyphs.emplace(key, glyph).first->second;
+	}
+
+	bool GlyphCache::Allocate(Page& page, std::uint32_t width, std::uint32_t height, std::uint32_t& x, std::uint32_t& y) noexcept
+	{
+		// Tightest shelf that does not waste more than a quarter of its height
+		Shelf* best = nullptr;
+		for(Shelf& shelf : page.shelves)
+		{
+			if(shelf.height < height || shelf.height > height + height / 4 + 2 || GLYPH_CACHE_PAGE_SIZE - shelf.x < width)
+				continue;
+			if(best == nullptr || shelf.height < best->height)
+				best = &shelf;
+		}
+		if(best == nullptr)
+		{
+			if(GLYPH_CACHE_PAGE_SIZE - page.next_shelf_y < height || width > GLYPH_CACHE_PAGE_SIZE)
+				return false;
+			best = &page.shelves.emplace_back(Shelf{ page.next_shelf_y, height, 0 });
+			page.next_shelf_y += height;
+		}
+		x = best->x;
+		y = best->y;
+		best->x += width;
+		return true;
+	}
+
+	bool GlyphCache::FindSpace(std::uint32_t width, std::uint32_t height, std::uint32_t& page, std::uint32_t& x, std::uint32_t& y)
+	{
+		for(page = 0; page < m_pages.size(); page++)
+		{
+			if(Allocate(*m_pages[page], width, height, x, y))
+				return true;
+		}
+
+		if(m_pages.size() < GLYPH_CACHE_MAX_PAGES)
+		{
+			auto new_page = std::make_unique<Page>();
+			new_page->pixels = CPUBuffer(GLYPH_CACHE_PAGE_SIZE * GLYPH_CACHE_PAGE_SIZE);
+			std::memset(new_page->pixels.GetData(), 0, new_page->pixels.GetSize());
+			new_page->texture.Init(new_page->pixels, GLYPH_CACHE_PAGE_SIZE, GLYPH_CACHE_PAGE_SIZE, VK_FORMAT_R8_UNORM, false, "scop_glyph_cache_page_" + std::to_string(m_pages.size()));
+			m_pages.push_back(std::move(new_page));
+			page = static_cast<std::uint32_t>(m_pages.size() - 1);
+			return Allocate(*m_pages[page], width, height, x, y);
+		}
+
+		std::uint32_t victim = GLYPH_CACHE_NO_PAGE;
+		for(std::uint32_t i = 0; i < m_pages.size(); i++)
+		{
+			if(m_pages[i]->last_use_frame + MAX_FRAMES_IN_FLIGHT > m_frame)
+				continue; // May still be sampled
+			if(victim == GLYPH_CACHE_NO_PAGE || m_pages[i]->last_use_frame < m_pages[victim]->last_use_frame)
+				victim = i;
+		}
+		if(victim == GLYPH_CACHE_NO_PAGE)
+			return false;
+		EvictPage(victim);
+		page = victim;
+		return Allocate(*m_pages[page], width, height, x, y);
+	}
+
+	void GlyphCache::EvictPage(std::uint32_t page) noexcept
+	{
+		std::erase_if(m_glyphs, [page](const auto& pair) { return pair.second.page == page; });
+		Page& evicted = *m_pages[page];
+		std::memset(evicted.pixels.GetData(), 0, evicted.pixels.GetSize());
+		evicted.shelves.clear();
+		evicted.next_shelf_y = 0;
+		evicted.generation++; // Texts built on this page rebuild their meshes
+		// Old glyphs stay on the GPU until overwritten, nothing samples them anymore
+		DebugLog("Graphics: glyph cache page % evicted", page);
+	}
+
+	void GlyphCache::MarkPageUsed(std::uint32_t page) noexcept
+	{
+		if(page < m_pages.size())
+			m_pages[page]->last_use_frame = m_frame;
+	}
+
+	void GlyphCache::Flush()
+	{
+		for(auto& page : m_pages)
+		{
+			if(page->dirty_min_x >= page->dirty_max_x || page->dirty_min_y >= page->dirty_max_y)
+				continue;
+			// Padding texels are included so evicted glyphs cannot bleed into new ones
+			std::uint32_t max_x = std::min(page->dirty_max_x + GLYPH_PADDING, GLYPH_CACHE_PAGE_SIZE);
+			std::uint32_t max_y = std::min(page->dirty_max_y + GLYPH_PADDING, GLYPH_CACHE_PAGE_SIZE);
+			std::uint32_t width = max_x - page->dirty_min_x;
+			std::uint32_t height = max_y - page->dirty_min_y;
+			CPUBuffer region(width * height);
+			for(std::uint32_t row = 0; row < height; row++)
+				std::memcpy(region.GetData() + row * width, page->pixels.GetData() + (page->dirty_min_y + row) * GLYPH_CACHE_PAGE_SIZE + page->dirty_min_x, width);
+			page->texture.UploadRegion(region, page->dirty_min_x, page->dirty_min_y, width, height);
+			page->dirty_min_x = GLYPH_CACHE_PAGE_SIZE;
+			page->dirty_min_y = GLYPH_CACHE_PAGE_SIZE;
+			page->dirty_max_x = 0;
+			page->dirty_max_y = 0;
+		}
+	}
+
+	void GlyphCache::Update() noexcept
+	{
+		m_frame++;
+	}
+
+	void GlyphCache::Destroy() noexcept
+	{
+		m_glyphs.clear();
+		m_pages.clear();
+		Message("Graphics: glyph cache destroyed");
+	}
+}
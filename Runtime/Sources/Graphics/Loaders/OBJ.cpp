@@ -1,94 +1,409 @@
 #include <Graphics/Loaders/OBJ.h>
+#include <Platform/MappedFile.h>
 #include <Core/Logs.h>
 
 #include <set>
-#include <fstream>
+#include <thread>
+#include <functional>
+#include <cstring>
+#include <charconv>
 #include <algorithm>
+#include <unordered_map>
 
 namespace Scop
 {
-	std::optional<ObjData> LoadObjFromFile(const std::filesystem::path& path)
+	namespace Internal
 	{
-		if(!std::filesystem::exists(path))
+		constexpr std::size_t OBJ_MIN_CHUNK_SIZE = 4 * 1024 * 1024; // Smaller files are not worth a thread
+
+		// Faces and group statements of a line aligned part of the file
+		struct ObjChunk
 		{
-			Error("OBJ loader: OBJ file does not exists; %", path);
-			return std::nullopt;
+			struct Segment
+			{
+				std::vector<std::string> groups; // Only used when the segment starts with a group statement
+				std::uint32_t first_face;
+				bool has_groups;
+			};
+
+			std::vector<Vec4f> color;
+			std::vector<Vec3f> vertex;
+			std::vector<Vec3f> normal;
+			std::vector<Vec2f> tex_coord;
+			std::vector<ObjData::FaceVertex> face_vertices;
+			std::vector<std::uint8_t> relative_indices; // Per face vertex, bit 0 for v, 1 for t and 2 for n
+			std::vector<std::uint32_t> face_starts;
+			std::vector<Segment> segments;
+		};
+
+		inline bool IsBlank(char c) noexcept
+		{
+			return c == ' ' || c == '\t' || c == '\r';
 		}
-		char line[1024];
-		std::string op;
-		std::istringstream line_in;
-		std::set<std::string> groups;
-		groups.insert("default");
 
-		std::ifstream in(path);
+		inline void SkipBlanks(const char*& it, const char* end) noexcept
+		{
+			while(it < end && IsBlank(*it))
+				it++;
+		}
 
-		ObjData data;
+		inline std::string_view ReadToken(const char*& it, const char* end) noexcept
+		{
+			SkipBlanks(it, end);
+			const char* start = it;
+			while(it < end && !IsBlank(*it))
+				it++;
+			return std::string_view{ start, static_cast<std::size_t>(it - start) };
+		}
 
-		while(in.good())
+		// Not locale aware unlike streams
+		inline float ReadFloat(const char*& it, const char* end) noexcept
 		{
-			in.getline(line, 1023);
-			line_in.clear();
-			line_in.str(line);
+			SkipBlanks(it, end);
+			if(it < end && *it == '+')
+				it++;
+			float value = 0.0f;
+			auto result = std::from_chars(it, end, value);
+			if(result.ec == std::errc{})
+				it = result.ptr;
+			return value;
+		}
+
+		// OBJ indices start at 1, negative ones are relative to the last element defined so far
+		inline bool ReadIndex(const char*& it, const char* end, std::int32_t local_count, std::int32_t& index, bool& relative) noexcept
+		{
+			std::int32_t value = 0;
+			auto result = std::from_chars(it, end, value);
+			if(result.ec != std::errc{})
+				return false;
+			it = result.ptr;
+			relative = value < 0;
+			index = relative ? local_count + value : value - 1;
+			return true;
+		}
 
-			if(!(line_in >> op))
-				continue;
+		// Calls func(op, it, line_end) for every line, it then points right after the statement
+		template<typename F>
+		void ForEachObjLine(const char* begin, const char* end, F&& func)
+		{
+			const char* it = begin;
+			while(it < end)
+			{
+				const char* line_end = static_cast<const char*>(std::memchr(it, '\n', end - it));
+				if(line_end == nullptr)
+					line_end = end;
+				std::string_view op = ReadToken(it, line_end);
+				func(op, it, line_end);
+				it = line_end + 1;
+			}
+		}
 
+		// Chunks and streamed attributes both have color, vertex, normal and tex_coord vectors
+		template<typename T>
+		bool ReadObjAttribute(std::string_view op, const char*& it, const char* end, T& data)
+		{
 			if(op == "v")
 			{
-				Vec3f v;
-				line_in >> v.x;
-				line_in >> v.y;
-				line_in >> v.z;
-				data.vertex.push_back(std::move(v));
+				Vec3f& v = data.vertex.emplace_back();
+				v.x = ReadFloat(it, end);
+				v.y = ReadFloat(it, end);
+				v.z = ReadFloat(it, end);
 			}
 			else if(op == "vt")
 			{
-				Vec2f v;
-				line_in >> v.x;
-				line_in >> v.y;
-				data.tex_coord.push_back(std::move(v));
+				Vec2f& v = data.tex_coord.emplace_back();
+				v.x = ReadFloat(it, end);
+				v.y = ReadFloat(it, end);
 			}
 			else if(op == "vn")
 			{
-				Vec3f v;
-				line_in >> v.x;
-				line_in >> v.y;
-				line_in >> v.z;
-				data.normal.push_back(std::move(v));
+				Vec3f& v = data.normal.emplace_back();
+				v.x = ReadFloat(it, end);
+				v.y = ReadFloat(it, end);
+				v.z = ReadFloat(it, end);
 			}
 			else if(op == "vc")
 			{
-				Vec4f v;
-				line_in >> v.x;
-				line_in >> v.y;
-				line_in >> v.z;
-				line_in >> v.w;
-				data.color.push_back(std::move(v));
+				Vec4f& v = data.color.emplace_back();
+				v.x = ReadFloat(it, end);
+				v.y = ReadFloat(it, end);
+				v.z = ReadFloat(it, end);
+				v.w = ReadFloat(it, end);
+			}
+			else
+				return false;
+			return true;
+		}
+
+		// counts are the v, vt and vn defined so far. Bits 0, 1 and 2 of relative_mask tell which indices were relative
+		inline bool ReadFaceVertex(const char*& it, const char* end, const std::int32_t (&counts)[3], ObjData::FaceVertex& face, std::uint8_t& relative_mask) noexcept
+		{
+			SkipBlanks(it, end);
+			face = ObjData::FaceVertex{};
+			bool relative;
+			if(!ReadIndex(it, end, counts[0], face.v, relative))
+				return false;
+			relative_mask = relative;
+			if(it < end && *it == '/')
+			{
+				it++;
+				if(ReadIndex(it, end, counts[1], face.t, relative))
+					relative_mask |= relative << 1;
+				if(it < end && *it == '/')
+				{
+					it++;
+					if(ReadIndex(it, end, counts[2], face.n, relative))
+						relative_mask |= relative << 2;
+				}
 			}
-			else if(op == "g")
+			return true;
+		}
+
+		struct ObjAttributeCounts
+		{
+			std::size_t vertex;
+			std::size_t tex_coord;
+			std::size_t normal;
+			std::size_t color;
+		};
+
+		// Missing t and n fall back to v when the attribute exists, like the models built from the faces do
+		inline bool IsFaceVertexInRange(const ObjData::FaceVertex& face, const ObjAttributeCounts& counts) noexcept
+		{
+			auto in_range = [](std::int32_t index, std::size_t count) { return index >= 0 && static_cast<std::size_t>(index) < count; };
+			if(!in_range(face.v, counts.vertex) || face.t < -1 || face.n < -1)
+				return false;
+			if(counts.tex_coord != 0 && !in_range(face.t > -1 ? face.t : face.v, counts.tex_coord))
+				return false;
+			if(counts.normal != 0 && !in_range(face.n > -1 ? face.n : face.v, counts.normal))
+				return false;
+			return counts.color == 0 || in_range(face.v, counts.color);
+		}
+
+		void ParseObjChunk(const char* begin, const char* end, ObjChunk& chunk)
+		{
+			ForEachObjLine(begin, end, [&chunk](std::string_view op, const char*& it, const char* line_end)
+			{
+				if(ReadObjAttribute(op, it, line_end, chunk))
+					return;
+				if(op == "g")
+				{
+					ObjChunk::Segment& segment = chunk.segments.emplace_back();
+					segment.first_face = static_cast<std::uint32_t>(chunk.face_starts.size());
+					segment.has_groups = true;
+					for(std::string_view group = ReadToken(it, line_end); !group.empty(); group = ReadToken(it, line_end))
+						segment.groups.emplace_back(group);
+				}
+				else if(op == "f")
+				{
+					chunk.face_starts.push_back(static_cast<std::uint32_t>(chunk.face_vertices.size()));
+					const std::int32_t counts[3] = { static_cast<std::int32_t>(chunk.vertex.size()), static_cast<std::int32_t>(chunk.tex_coord.size()), static_cast<std::int32_t>(chunk.normal.size()) };
+					ObjData::FaceVertex face;
+					std::uint8_t relative_mask;
+					while(ReadFaceVertex(it, line_end, counts, face, relative_mask))
+					{
+						chunk.face_vertices.push_back(face);
+						chunk.relative_indices.push_back(relative_mask);
+					}
+				}
+			});
+		}
+
+		constexpr std::size_t OBJ_STREAM_WINDOW_SIZE = 64 * 1024 * 1024;
+
+		// Reads the file by line aligned windows, the pages of a window are dropped once it has been parsed
+		template<typename F>
+		void StreamObjPass(MappedFile& file, F&& func)
+		{
+			const char* begin = file.GetData();
+			const char* end = begin + file.GetSize();
+			while(begin < end)
 			{
-				groups.clear();
-				while(line_in >> groups);
-				groups.insert("default");
+				const char* window_end = begin + std::min<std::size_t>(OBJ_STREAM_WINDOW_SIZE, end - begin);
+				if(window_end < end)
+				{
+					const char* line_end = static_cast<const char*>(std::memchr(window_end, '\n', end - window_end));
+					window_end = (line_end == nullptr ? end : line_end + 1);
+				}
+				ForEachObjLine(begin, window_end, func);
+				file.Release(begin, window_end);
+				begin = window_end;
 			}
-			else if(op == "f")
+		}
+
+		// Relative indices are resolved against the attributes defined so far in the file. Points and lines are skipped
+		template<typename G, typename F>
+		void StreamObjFaces(MappedFile& file, G&& on_group, F&& on_face)
+		{
+			std::int32_t counts[3] = { 0, 0, 0 };
+			std::vector<ObjData::FaceVertex> polygon;
+			StreamObjPass(file, [&](std::string_view op, const char*& it, const char* end)
 			{
-				std::vector<ObjData::FaceVertex> list;
-				while(line_in >> list);
-				for(const auto& group : groups)
+				if(op == "v")
+					counts[0]++;
+				else if(op == "vt")
+					counts[1]++;
+				else if(op == "vn")
+					counts[2]++;
+				else if(op == "g")
+					on_group(it, end);
+				else if(op == "f")
+				{
+					polygon.clear();
+					ObjData::FaceVertex face;
+					std::uint8_t relative_mask;
+					while(ReadFaceVertex(it, end, counts, face, relative_mask))
+						polygon.push_back(face);
+					if(polygon.size() >= 3)
+						on_face(polygon);
+				}
+			});
+		}
+
+		struct ObjChunkBuilder
+		{
+			ObjModelChunk chunk;
+			std::unordered_map<ObjData::FaceVertex, std::uint32_t> unique; // Only the vertices of the current chunk
+		};
+	}
+
+	std::optional<ObjData> LoadObjFromFile(const std::filesystem::path& path)
+	{
+		if(!std::filesystem::exists(path))
+		{
+			Error("OBJ loader: OBJ file does not exists; %", path);
+			return std::nullopt;
+		}
+		MappedFile file;
+		if(!file.Open(path))
+			return std::nullopt;
+
+		// Line aligned chunks parsed in parallel
+		const char* begin = file.GetData();
+		const char* end = begin + file.GetSize();
+		std::size_t chunks_count = std::clamp<std::size_t>(file.GetSize() / Internal::OBJ_MIN_CHUNK_SIZE, 1, std::max(std::thread::hardware_concurrency(), 1u));
+		std::vector<const char*> bounds{ begin };
+		for(std::size_t i = 1; i < chunks_count; i++)
+		{
+			const char* split = std::max(begin + file.GetSize() * i / chunks_count, bounds.back());
+			const char* line_end = static_cast<const char*>(std::memchr(split, '\n', end - split));
+			bounds.push_back(line_end == nullptr ? end : line_end + 1);
+		}
+		bounds.push_back(end);
+
+		std::vector<Internal::ObjChunk> chunks(chunks_count);
+		std::vector<std::thread> workers;
+		for(std::size_t i = 1; i < chunks_count; i++)
+			workers.emplace_back(Internal::ParseObjChunk, bounds[i], bounds[i + 1], std::ref(chunks[i]));
+		Internal::ParseObjChunk(bounds[0], bounds[1], chunks[0]);
+		for(std::thread& worker : workers)
+			worker.join();
+
+		ObjData data;
+		std::size_t vertex_count = 0, tex_coord_count = 0, normal_count = 0, color_count = 0;
+		for(const Internal::ObjChunk& chunk : chunks)
+		{
+			vertex_count += chunk.vertex.size();
+			tex_coord_count += chunk.tex_coord.size();
+			normal_count += chunk.normal.size();
+			color_count += chunk.color.size();
+		}
+		data.vertex.reserve(vertex_count);
+		data.tex_coord.reserve(tex_coord_count);
+		data.normal.reserve(normal_count);
+		data.color.reserve(color_count);
+
+		std::vector<std::string> groups{ "default" };
+		const Internal::ObjAttributeCounts counts{ vertex_count, tex_coord_count, normal_count, color_count };
+		std::size_t skipped_faces = 0;
+		for(Internal::ObjChunk& chunk : chunks)
+		{
+			// Relative indices were resolved against the chunk, they now get the elements of previous chunks
+			std::int32_t vertex_base = static_cast<std::int32_t>(data.vertex.size());
+			std::int32_t tex_coord_base = static_cast<std::int32_t>(data.tex_coord.size());
+			std::int32_t normal_base = static_cast<std::int32_t>(data.normal.size());
+			data.vertex.insert(data.vertex.end(), chunk.vertex.begin(), chunk.vertex.end());
+			data.tex_coord.insert(data.tex_coord.end(), chunk.tex_coord.begin(), chunk.tex_coord.end());
+			data.normal.insert(data.normal.end(), chunk.normal.begin(), chunk.normal.end());
+			data.color.insert(data.color.end(), chunk.color.begin(), chunk.color.end());
+			for(std::size_t i = 0; i < chunk.face_vertices.size(); i++)
+			{
+				std::uint8_t mask = chunk.relative_indices[i];
+				if(mask == 0)
+					continue;
+				ObjData::FaceVertex& face = chunk.face_vertices[i];
+				if(mask & 1)
+					face.v += vertex_base;
+				if(mask & 2)
+					face.t += tex_coord_base;
+				if(mask & 4)
+					face.n += normal_base;
+			}
+
+			// Faces with an index out of the file attributes are removed, segments are moved to the faces kept before them
+			chunk.face_starts.push_back(static_cast<std::uint32_t>(chunk.face_vertices.size()));
+			std::uint32_t kept_faces = 0;
+			std::uint32_t kept_vertices = 0;
+			std::size_t segment = 0;
+			for(std::uint32_t face = 0; face + 1 < chunk.face_starts.size(); face++)
+			{
+				for(; segment < chunk.segments.size() && chunk.segments[segment].first_face == face; segment++)
+					chunk.segments[segment].first_face = kept_faces;
+				auto first = chunk.face_vertices.begin() + chunk.face_starts[face];
+				auto last = chunk.face_vertices.begin() + chunk.face_starts[face + 1];
+				if(!std::all_of(first, last, [&counts](const ObjData::FaceVertex& face_vertex) { return Internal::IsFaceVertexInRange(face_vertex, counts); }))
+				{
+					skipped_faces++;
+					continue;
+				}
+				auto destination = chunk.face_vertices.begin() + kept_vertices;
+				if(destination != first)
+					std::copy(first, last, destination);
+				chunk.face_starts[kept_faces++] = kept_vertices;
+				kept_vertices += static_cast<std::uint32_t>(last - first);
+			}
+			for(; segment < chunk.segments.size(); segment++)
+				chunk.segments[segment].first_face = kept_faces;
+			chunk.face_vertices.resize(kept_vertices);
+			chunk.face_starts.resize(kept_faces);
+
+			chunk.face_starts.push_back(static_cast<std::uint32_t>(chunk.face_vertices.size()));
+			std::uint32_t faces_count = static_cast<std::uint32_t>(chunk.face_starts.size() - 1);
+			for(std::size_t s = 0; s <= chunk.segments.size(); s++)
+			{
+				std::uint32_t first_face = (s == 0 ? 0 : chunk.segments[s - 1].first_face);
+				std::uint32_t last_face = (s == chunk.segments.size() ? faces_count : chunk.segments[s].first_face);
+				if(s > 0)
+				{
+					groups = std::move(chunk.segments[s - 1].groups);
+					if(std::find(groups.begin(), groups.end(), "default") == groups.end())
+						groups.push_back("default");
+					std::sort(groups.begin(), groups.end());
+					groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+				}
+				if(first_face == last_face)
+					continue;
+				auto first = chunk.face_vertices.begin() + chunk.face_starts[first_face];
+				auto last = chunk.face_vertices.begin() + chunk.face_starts[last_face];
+				for(const std::string& group : groups)
 				{
 					ObjData::FaceList& fl = data.faces[group];
-					fl.second.push_back(fl.first.size());
-					fl.first.insert(fl.first.end(), list.begin(), list.end());
+					std::uint32_t base = static_cast<std::uint32_t>(fl.first.size()) - chunk.face_starts[first_face];
+					for(std::uint32_t face = first_face; face < last_face; face++)
+						fl.second.push_back(chunk.face_starts[face] + base);
+					fl.first.insert(fl.first.end(), first, last);
 				}
 			}
+			chunk = {}; // Frees the chunk before merging the next one
 		}
 		for(auto& [_, face] : data.faces)
 		{
 			ObjData::FaceList& fl = face;
 			fl.second.push_back(fl.first.size());
 		}
-		Message("OBJ Loader: loaded %", path);
+		if(skipped_faces != 0)
+			Warning("OBJ loader: % faces with out of range indices skipped in %", skipped_faces, path);
+		Message("OBJ Loader: loaded % (% MB parsed by % threads)", path, file.GetSize() / (1024 * 1024), chunks_count);
 		return data;
 	}
 
@@ -135,37 +450,202 @@ namespace Scop
 
 	ObjModel ConvertObjDataToObjModel(const ObjData& data)
 	{
-		std::vector<ObjData::FaceVertex> unique(data.faces.find("default")->second.first);
-		std::sort(unique.begin(), unique.end());
-		//unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
-
 		ObjModel model;
-		for(auto& face : unique)
+		std::unordered_map<ObjData::FaceVertex, std::uint32_t> unique;
+		auto default_group = data.faces.find("default"); // Every face is in the default group
+		std::size_t face_vertices_count = (default_group != data.faces.end() ? default_group->second.first.size() : 0);
+		unique.reserve(face_vertices_count);
+
+		for(auto& [group, faces] : data.faces)
 		{
-			model.vertex.push_back(data.vertex[face.v]);
-			if(!data.tex_coord.empty())
+			std::vector<std::uint32_t>& v = model.faces[group];
+			v.reserve(faces.first.size());
+			for(const ObjData::FaceVertex& face : faces.first)
 			{
-				const int index = (face.t > -1) ? face.t : face.v;
-				model.tex_coord.push_back(data.tex_coord[index]);
+				auto [it, inserted] = unique.try_emplace(face, static_cast<std::uint32_t>(model.vertex.size()));
+				if(inserted)
+				{
+					model.vertex.push_back(data.vertex[face.v]);
+					if(!data.tex_coord.empty())
+					{
+						const int index = (face.t > -1) ? face.t : face.v;
+						model.tex_coord.push_back(data.tex_coord[index]);
+					}
+					if(!data.normal.empty())
+					{
+						const int index = (face.n > -1) ? face.n : face.v;
+						model.normal.push_back(data.normal[index]);
+					}
+					if(!data.color.empty())
+						model.color.push_back(data.color[face.v]);
+				}
+				v.push_back(it->second);
 			}
-			if(!data.normal.empty())
+		}
+		Message("OBJ Loader : % distinct vertices for % face vertices", model.vertex.size(), face_vertices_count);
+		return model;
+	}
+
+	bool StreamObjFile(const std::filesystem::path& path, std::uint32_t chunk_vertices, ObjStreamInfos& infos, const std::function<void(const ObjModelChunk&)>& callback)
+	{
+		if(!std::filesystem::exists(path))
+		{
+			Error("OBJ loader: OBJ file does not exists; %", path);
+			return false;
+		}
+		MappedFile file;
+		if(!file.Open(path))
+			return false;
+		chunk_vertices = std::max(chunk_vertices, 3u);
+		const std::size_t chunk_indices = std::size_t(chunk_vertices) * OBJ_STREAM_INDICES_PER_VERTEX;
+
+		// Faces are not stored, only the attributes they reference
+		ObjData attributes;
+		Internal::StreamObjPass(file, [&attributes](std::string_view op, const char*& it, const char* end)
+		{
+			Internal::ReadObjAttribute(op, it, end, attributes);
+		});
+		if(attributes.vertex.empty())
+		{
+			Error("OBJ loader: no vertex in %", path);
+			return false;
+		}
+
+		infos = {};
+		infos.aabb_min = attributes.vertex.front();
+		infos.aabb_max = attributes.vertex.front();
+		for(const Vec3f& vertex : attributes.vertex)
+		{
+			infos.aabb_min = Vec3f{ std::min(vertex.x, infos.aabb_min.x), std::min(vertex.y, infos.aabb_min.y), std::min(vertex.z, infos.aabb_min.z) };
+			infos.aabb_max = Vec3f{ std::max(vertex.x, infos.aabb_max.x), std::max(vertex.y, infos.aabb_max.y), std::max(vertex.z, infos.aabb_max.z) };
+		}
+
+		for(Vec3f& normal : attributes.normal)
+			normal = normal.GetNormal();
+
+		// Faces referencing attributes the file does not have are skipped by both face passes
+		const Internal::ObjAttributeCounts counts{ attributes.vertex.size(), attributes.tex_coord.size(), attributes.normal.size(), attributes.color.size() };
+		auto is_polygon_in_range = [&counts](const std::vector<ObjData::FaceVertex>& polygon)
+		{
+			return std::all_of(polygon.begin(), polygon.end(), [&counts](const ObjData::FaceVertex& face) { return Internal::IsFaceVertexInRange(face, counts); });
+		};
+
+		std::vector<Vec3f> generated_normals;
+		if(attributes.normal.empty())
+		{
+			// Cross products are not normalised so bigger faces weigh more
+			generated_normals.assign(attributes.vertex.size(), Vec3f{ 0.0f });
+			Internal::StreamObjFaces(file, [](const char*&, const char*) {}, [&](const std::vector<ObjData::FaceVertex>& polygon)
 			{
-				const int index = (face.n > -1) ? face.n : face.v;
-				model.normal.push_back(data.normal[index]);
-			}
-			if(!data.color.empty())
+				if(!is_polygon_in_range(polygon))
+					return;
+				const Vec3f& origin = attributes.vertex[polygon[0].v];
+				for(std::size_t i = 1; i + 1 < polygon.size(); i++)
+				{
+					Vec3f normal = (attributes.vertex[polygon[i].v] - origin).CrossProduct(attributes.vertex[polygon[i + 1].v] - origin);
+					generated_normals[polygon[0].v] += normal;
+					generated_normals[polygon[i].v] += normal;
+					generated_normals[polygon[i + 1].v] += normal;
+				}
+			});
+			for(Vec3f& normal : generated_normals)
 			{
-				const int index = face.v;
-				model.color.push_back(data.color[index]);
+				float length = normal.GetLength();
+				if(length > 0.0f)
+					normal /= length;
 			}
 		}
-		for(auto& [group, faces] : data.faces)
+		const std::vector<Vec3f>& normals = (attributes.normal.empty() ? generated_normals : attributes.normal);
+
+		std::map<std::string, Internal::ObjChunkBuilder, std::less<>> builders;
+		auto get_builder = [&](std::string_view group) -> Internal::ObjChunkBuilder&
 		{
-			std::vector<std::uint32_t>& v = model.faces[group];
-			v.reserve(faces.first.size());
-			for(auto& face : faces.first)
-				v.push_back(std::distance(unique.begin(), std::lower_bound(unique.begin(), unique.end(), face)));
-		}
-		return model;
+			auto it = builders.find(group);
+			if(it == builders.end())
+			{
+				it = builders.try_emplace(std::string{ group }).first;
+				it->second.chunk.group = group;
+				it->second.unique.reserve(chunk_vertices);
+			}
+			return it->second;
+		};
+		auto emit = [&](Internal::ObjChunkBuilder& builder)
+		{
+			if(builder.chunk.indices.empty())
+				return;
+			callback(builder.chunk);
+			infos.chunk_count++;
+			// Capacities are kept for the next chunk of the group
+			builder.chunk.color.clear();
+			builder.chunk.vertex.clear();
+			builder.chunk.normal.clear();
+			builder.chunk.tex_coord.clear();
+			builder.chunk.indices.clear();
+			builder.unique.clear();
+		};
+		auto add_face_vertex = [&](Internal::ObjChunkBuilder& builder, const ObjData::FaceVertex& face)
+		{
+			ObjModelChunk& chunk = builder.chunk;
+			auto [it, inserted] = builder.unique.try_emplace(face, static_cast<std::uint32_t>(chunk.vertex.size()));
+			if(inserted)
+			{
+				chunk.vertex.push_back(attributes.vertex[face.v]);
+				chunk.normal.push_back(normals[(face.n > -1 && !attributes.normal.empty()) ? face.n : face.v]);
+				if(!attributes.tex_coord.empty())
+					chunk.tex_coord.push_back(attributes.tex_coord[(face.t > -1) ? face.t : face.v]);
+				if(!attributes.color.empty())
+					chunk.color.push_back(attributes.color[face.v]);
+			}
+			chunk.indices.push_back(it->second);
+		};
+
+		// Every face is in the default group, like with LoadObjFromFile
+		std::vector<Internal::ObjChunkBuilder*> groups{ &get_builder("default") };
+		std::vector<std::string_view> names;
+		bool warned_polygon = false;
+		bool warned_range = false;
+		Internal::StreamObjFaces(file, [&](const char*& it, const char* end)
+		{
+			names.assign(1, "default");
+			for(std::string_view group = Internal::ReadToken(it, end); !group.empty(); group = Internal::ReadToken(it, end))
+				names.push_back(group);
+			std::sort(names.begin(), names.end());
+			names.erase(std::unique(names.begin(), names.end()), names.end());
+			groups.clear();
+			for(std::string_view name : names)
+				groups.push_back(&get_builder(name));
+		},
+		[&](const std::vector<ObjData::FaceVertex>& polygon)
+		{
+			if(polygon.size() > chunk_vertices)
+			{
+				if(!warned_polygon)
+					Warning("OBJ loader: faces of more than % vertices are skipped in %", chunk_vertices, path);
+				warned_polygon = true;
+				return;
+			}
+			if(!is_polygon_in_range(polygon))
+			{
+				if(!warned_range)
+					Warning("OBJ loader: faces with out of range indices are skipped in %", path);
+				warned_range = true;
+				return;
+			}
+			for(Internal::ObjChunkBuilder* builder : groups)
+			{
+				if(builder->chunk.vertex.size() + polygon.size() > chunk_vertices || builder->chunk.indices.size() + (polygon.size() - 2) * 3 > chunk_indices)
+					emit(*builder);
+				for(std::size_t i = 1; i + 1 < polygon.size(); i++)
+				{
+					add_face_vertex(*builder, polygon[0]);
+					add_face_vertex(*builder, polygon[i]);
+					add_face_vertex(*builder, polygon[i + 1]);
+				}
+			}
+		});
+		for(auto& [_, builder] : builders)
+			emit(builder);
+		Message("OBJ Loader: streamed % (% MB in % chunks)", path, file.GetSize() / (1024 * 1024), infos.chunk_count);
+		return true;
 	}
 }
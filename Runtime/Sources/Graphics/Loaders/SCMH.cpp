@@ -0,0 +1,208 @@
+#include <Graphics/Loaders/SCMH.h>
+#include <Core/Logs.h>
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+namespace Scop
+{
+	namespace Internal
+	{
+		std::uint64_t HashFNV1a(const char* data, std::size_t size) noexcept
+		{
+			std::uint64_t hash = 0xCBF29CE484222325;
+			for(std::size_t i = 0; i < size; i++)
+			{
+				hash ^= static_cast<std::uint8_t>(data[i]);
+				hash *= 0x100000001B3;
+			}
+			return hash;
+		}
+	}
+
+	SCMHSourceStamp ComputeSCMHSourceStamp(const std::filesystem::path& source, bool with_hash)
+	{
+		SCMHSourceStamp stamp;
+		std::error_code error;
+		stamp.size = std::filesystem::file_size(source, error);
+		if(error)
+			return {};
+		stamp.mtime = std::filesystem::last_write_time(source, error).time_since_epoch().count();
+		if(with_hash)
+		{
+			MappedFile file;
+			if(file.Open(source))
+				stamp.hash = Internal::HashFNV1a(file.GetData(), file.GetSize());
+		}
+		return stamp;
+	}
+
+	bool IsSCMHUpToDate(const SCMHInfos& infos, const std::filesystem::path& source)
+	{
+		SCMHSourceStamp stamp = ComputeSCMHSourceStamp(source, false);
+		if(stamp.size != infos.source.size)
+			return false;
+		if(stamp.mtime == infos.source.mtime)
+			return true;
+		// Touched but maybe not modified, like after a checkout
+		return ComputeSCMHSourceStamp(source, true).hash == infos.source.hash;
+	}
+
+	bool LoadSCMHFile(const std::filesystem::path& path, MappedFile& file, SCMHInfos& infos)
+	{
+		if(!std::filesystem::exists(path) || !file.Open(path))
+			return false;
+		if(file.GetSize() < sizeof(SCMHHeader))
+		{
+			Error("SCMH loader: % is too small to be a SCMH file", path);
+			return false;
+		}
+
+		SCMHHeader header;
+		std::memcpy(&header, file.GetData(), sizeof(SCMHHeader));
+		if(header.magic != SCMH_MAGIC)
+		{
+			Error("SCMH loader: not a SCMH file, %", path);
+			return false;
+		}
+		if(header.version != SCMH_VERSION || header.vertex_size != sizeof(Vertex))
+		{
+			Warning("SCMH loader: % was written by another version of the engine", path);
+			return false;
+		}
+		if(header.table_offset < sizeof(SCMHHeader) || header.table_offset > file.GetSize() || std::uint64_t(header.submesh_count) * sizeof(SCMHSubMesh) > file.GetSize() - header.table_offset)
+		{
+			Error("SCMH loader: truncated sub mesh table in %", path);
+			return false;
+		}
+
+		infos.submeshes.resize(header.submesh_count);
+		std::memcpy(infos.submeshes.data(), file.GetData() + header.table_offset, header.submesh_count * sizeof(SCMHSubMesh));
+		for(std::size_t i = 0; i < infos.submeshes.size(); i++)
+		{
+			const SCMHSubMesh& submesh = infos.submeshes[i];
+			std::uint64_t size = std::uint64_t(submesh.vertex_count) * sizeof(Vertex) + std::uint64_t(submesh.index_count) * sizeof(std::uint32_t);
+			if(submesh.offset % SCMH_DATA_ALIGNMENT != 0 || submesh.offset > header.table_offset || size > header.table_offset - submesh.offset)
+			{
+				Error("SCMH loader: invalid sub mesh % in %", i, path);
+				return false;
+			}
+			// An index past the vertices would make the GPU read out of the vertex buffer
+			const std::uint32_t* indices = reinterpret_cast<const std::uint32_t*>(file.GetData() + submesh.offset + std::uint64_t(submesh.vertex_count) * sizeof(Vertex));
+			if(std::any_of(indices, indices + submesh.index_count, [&submesh](std::uint32_t index) { return index >= submesh.vertex_count; }))
+			{
+				Error("SCMH loader: sub mesh % of % has out of range indices", i, path);
+				return false;
+			}
+		}
+		infos.source = header.source;
+		infos.build_parameter = header.build_parameter;
+		infos.flags = header.flags;
+		infos.aabb_min = Vec3f{ header.aabb_min[0], header.aabb_min[1], header.aabb_min[2] };
+		infos.aabb_max = Vec3f{ header.aabb_max[0], header.aabb_max[1], header.aabb_max[2] };
+		return true;
+	}
+
+	bool SCMHWriter::Open(const std::filesystem::path& path)
+	{
+		m_path = path;
+		m_temporary_path = path;
+		m_temporary_path += ".tmp";
+		m_table.clear();
+		m_file.open(m_temporary_path, std::ios::binary | std::ios::trunc);
+		if(!m_file.is_open())
+		{
+			Warning("SCMH writer: could not open %", m_temporary_path);
+			return false;
+		}
+		SCMHHeader header{}; // Written again by Finish
+		m_file.write(reinterpret_cast<const char*>(&header), sizeof(SCMHHeader));
+		return true;
+	}
+
+	void SCMHWriter::Pad()
+	{
+		std::uint64_t offset = static_cast<std::uint64_t>(m_file.tellp());
+		for(; offset % SCMH_DATA_ALIGNMENT != 0; offset++)
+			m_file.put(0);
+	}
+
+	void SCMHWriter::AddSubMesh(const Vertex* vertices, std::uint32_t vertex_count, const std::uint32_t* indices, std::uint32_t index_count)
+	{
+		if(!m_file.is_open())
+			return;
+		Pad();
+		SCMHSubMesh& submesh = m_table.emplace_back();
+		submesh.offset = static_cast<std::uint64_t>(m_file.tellp());
+		submesh.vertex_count = vertex_count;
+		submesh.index_count = index_count;
+		m_file.write(reinterpret_cast<const char*>(vertices), std::size_t(vertex_count) * sizeof(Vertex));
+		m_file.write(reinterpret_cast<const char*>(indices), std::size_t(index_count) * sizeof(std::uint32_t));
+	}
+
+	bool SCMHWriter::Finish(const SCMHSourceStamp& source, float build_parameter, std::uint32_t flags, Vec3f aabb_min, Vec3f aabb_max)
+	{
+		if(!m_file.is_open())
+			return false;
+
+		SCMHHeader header{};
+		header.magic = SCMH_MAGIC;
+		header.version = SCMH_VERSION;
+		header.vertex_size = sizeof(Vertex);
+		header.submesh_count = static_cast<std::uint32_t>(m_table.size());
+		header.source = source;
+		header.build_parameter = build_parameter;
+		header.flags = flags;
+		header.aabb_min[0] = aabb_min.x;
+		header.aabb_min[1] = aabb_min.y;
+		header.aabb_min[2] = aabb_min.z;
+		header.aabb_max[0] = aabb_max.x;
+		header.aabb_max[1] = aabb_max.y;
+		header.aabb_max[2] = aabb_max.z;
+
+		Pad();
+		header.table_offset = static_cast<std::uint64_t>(m_file.tellp());
+		m_file.write(reinterpret_cast<const char*>(m_table.data()), m_table.size() * sizeof(SCMHSubMesh));
+		m_file.seekp(0);
+		m_file.write(reinterpret_cast<const char*>(&header), sizeof(SCMHHeader));
+		m_file.close();
+		if(!m_file)
+		{
+			Warning("SCMH writer: could not write %", m_temporary_path);
+			std::filesystem::remove(m_temporary_path);
+			return false;
+		}
+		std::error_code error;
+		std::filesystem::rename(m_temporary_path, m_path, error);
+		if(error)
+		{
+			Warning("SCMH writer: could not replace %", m_path);
+			std::filesystem::remove(m_temporary_path, error);
+			return false;
+		}
+		Message("SCMH Writer: wrote %", m_path);
+		return true;
+	}
+
+	SCMHWriter::~SCMHWriter()
+	{
+		// Unfinished caches are never left behind
+		if(m_file.is_open())
+		{
+			m_file.close();
+			std::error_code error;
+			std::filesystem::remove(m_temporary_path, error);
+		}
+	}
+
+	bool WriteSCMHFile(const std::filesystem::path& path, const SCMHSourceStamp& source, float build_parameter, std::uint32_t flags, Vec3f aabb_min, Vec3f aabb_max, const std::vector<SCMHSubMeshData>& submeshes)
+	{
+		SCMHWriter writer;
+		if(!writer.Open(path))
+			return false;
+		for(const SCMHSubMeshData& submesh : submeshes)
+			writer.AddSubMesh(submesh.vertices.data(), static_cast<std::uint32_t>(submesh.vertices.size()), submesh.indices.data(), static_cast<std::uint32_t>(submesh.indices.size()));
+		return writer.Finish(source, build_parameter, flags, aabb_min, aabb_max);
+	}
+}
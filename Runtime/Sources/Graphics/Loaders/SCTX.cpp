@@ -0,0 +1,76 @@
+#include <Graphics/Loaders/SCTX.h>
+#include <Renderer/TextureCompression.h>
+#include <Core/Logs.h>
+
+#include <fstream>
+#include <cstring>
+
+namespace Scop
+{
+	CPUBuffer LoadSCTXFile(const std::filesystem::path& path, SCTXInfos& infos)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if(!file.is_open())
+		{
+			Error("SCTX loader: could not open %", path);
+			return {};
+		}
+		std::size_t file_size = static_cast<std::size_t>(file.tellg());
+		if(file_size < sizeof(SCTXHeader))
+		{
+			Error("SCTX loader: % is too small to be a SCTX file", path);
+			return {};
+		}
+		CPUBuffer data(file_size);
+		file.seekg(0, std::ios::beg);
+		if(!file.read(reinterpret_cast<char*>(data.GetData()), file_size))
+		{
+			Error("SCTX loader: could not read %", path);
+			return {};
+		}
+
+		SCTXHeader header;
+		std::memcpy(&header, data.GetData(), sizeof(SCTXHeader));
+		if(header.magic != SCTX_MAGIC)
+		{
+			Error("SCTX loader: not a SCTX file, %", path);
+			return {};
+		}
+		if(header.version != SCTX_VERSION)
+		{
+			Error("SCTX loader: unsupported version % in %", header.version, path);
+			return {};
+		}
+		if(header.width == 0 || header.height == 0 || header.mip_count == 0 || header.mip_count > ComputeMipLevelsCount(header.width, header.height))
+		{
+			Error("SCTX loader: invalid dimensions or mip count in %", path);
+			return {};
+		}
+		if(file_size < sizeof(SCTXHeader) + header.mip_count * sizeof(SCTXMip))
+		{
+			Error("SCTX loader: truncated mip table in %", path);
+			return {};
+		}
+
+		VkFormat format = static_cast<VkFormat>(header.format);
+		infos.mip_offsets.resize(header.mip_count);
+		for(std::uint32_t i = 0; i < header.mip_count; i++)
+		{
+			SCTXMip mip;
+			std::memcpy(&mip, data.GetData() + sizeof(SCTXHeader) + i * sizeof(SCTXMip), sizeof(SCTXMip));
+			std::uint32_t width = std::max(header.width >> i, 1u);
+			std::uint32_t height = std::max(header.height >> i, 1u);
+			std::size_t expected_size = (IsBlockCompressedFormat(format) ? ComputeCompressedLevelSize(format, width, height) : std::size_t(width) * height * kvfFormatSize(format));
+			if(expected_size == 0 || mip.offset % SCTX_DATA_ALIGNMENT != 0 || mip.offset > file_size || mip.size > file_size - mip.offset || mip.size != expected_size)
+			{
+				Error("SCTX loader: invalid mip % in %", i, path);
+				return {};
+			}
+			infos.mip_offsets[i] = mip.offset;
+		}
+		infos.dimensions = Vec2ui32{ header.width, header.height };
+		infos.format = format;
+		Message("SCTX Loader: loaded %", path);
+		return data;
+	}
+}
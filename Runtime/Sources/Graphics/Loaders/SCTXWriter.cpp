@@ -0,0 +1,60 @@
+#include <Graphics/Loaders/SCTX.h>
+#include <Core/Logs.h>
+
+#include <fstream>
+
+// Apart from the loader so offline tools can write SCTX files without pulling the KVF implementation
+
+namespace Scop
+{
+	bool WriteSCTXFile(const std::filesystem::path& path, VkFormat format, Vec2ui32 dimensions, const std::vector<CPUBuffer>& mips)
+	{
+		if(mips.empty())
+		{
+			Error("SCTX writer: no mip to write in %", path);
+			return false;
+		}
+		std::ofstream file(path, std::ios::binary);
+		if(!file.is_open())
+		{
+			Error("SCTX writer: could not open %", path);
+			return false;
+		}
+
+		SCTXHeader header;
+		header.magic = SCTX_MAGIC;
+		header.version = SCTX_VERSION;
+		header.format = static_cast<std::uint32_t>(format);
+		header.width = dimensions.x;
+		header.height = dimensions.y;
+		header.mip_count = static_cast<std::uint32_t>(mips.size());
+
+		auto align = [](std::uint64_t offset) { return (offset + SCTX_DATA_ALIGNMENT - 1) / SCTX_DATA_ALIGNMENT * SCTX_DATA_ALIGNMENT; };
+
+		std::vector<SCTXMip> table(mips.size());
+		std::uint64_t offset = align(sizeof(SCTXHeader) + table.size() * sizeof(SCTXMip));
+		for(std::size_t i = 0; i < mips.size(); i++)
+		{
+			table[i].offset = offset;
+			table[i].size = mips[i].GetSize();
+			offset = align(offset + table[i].size);
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(SCTXHeader));
+		file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SCTXMip));
+		for(std::size_t i = 0; i < mips.size(); i++)
+		{
+			std::size_t padding = table[i].offset - static_cast<std::uint64_t>(file.tellp());
+			for(std::size_t j = 0; j < padding; j++)
+				file.put(0);
+			file.write(reinterpret_cast<const char*>(mips[i].GetData()), mips[i].GetSize());
+		}
+		if(!file)
+		{
+			Error("SCTX writer: could not write %", path);
+			return false;
+		}
+		Message("SCTX Writer: wrote %", path);
+		return true;
+	}
+}
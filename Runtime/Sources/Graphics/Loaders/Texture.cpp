@@ -0,0 +1,29 @@
+#include <Graphics/Loaders/Texture.h>
+#include <Graphics/Loaders/BMP.h>
+#include <Graphics/Loaders/SCTX.h>
+
+namespace Scop
+{
+	std::shared_ptr<Texture> LoadTextureFromFile(const std::filesystem::path& path, TextureMipmapMode mipmaps)
+	{
+		if(path.extension() == ".sctx")
+		{
+			SCTXInfos infos;
+			CPUBuffer data = LoadSCTXFile(path, infos);
+			if(!data)
+				return nullptr;
+			if(mipmaps == TextureMipmapMode::None)
+				infos.mip_offsets.resize(1);
+			std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+			if(!texture->InitFromMipChain(std::move(data), infos.mip_offsets, infos.dimensions.x, infos.dimensions.y, infos.format, path.stem().string(), mipmaps == TextureMipmapMode::Stream))
+				return nullptr;
+			return texture;
+		}
+
+		Vec2ui32 dimensions;
+		CPUBuffer pixels = LoadBMPFile(path, dimensions);
+		if(!pixels)
+			return nullptr;
+		return std::make_shared<Texture>(std::move(pixels), dimensions.x, dimensions.y, VK_FORMAT_R8G8B8A8_SRGB, false, path.stem().string(), false, mipmaps);
+	}
+}
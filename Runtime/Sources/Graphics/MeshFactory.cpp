@@ -1,5 +1,6 @@
 #include <Graphics/MeshFactory.h>
 #include <Graphics/Mesh.h>
+#include <Graphics/MeshOptimizer.h>
 #include <Renderer/Vertex.h>
 #include <Maths/Constants.h>
 #include <Maths/Quaternions.h>
@@ -374,6 +375,7 @@ namespace Scop
 				}
 			}
 		}
+		OptimizeMesh(data, indices); // Rows are longer than the vertex cache
 
 		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
 		mesh->AddSubMesh({ std::move(data), std::move(indices) });
@@ -557,6 +559,7 @@ namespace Scop
 			prevrow = thisrow;
 			thisrow = point;
 		}
+		OptimizeMesh(data, indices);
 
 		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
 		mesh->AddSubMesh({ std::move(data), std::move(indices) });
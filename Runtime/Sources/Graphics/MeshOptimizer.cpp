@@ -0,0 +1,243 @@
+#include <Graphics/MeshOptimizer.h>
+#include <Maths/Vec3.h>
+
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+namespace Scop
+{
+	VertexCacheStatistics AnalyzeVertexCache(const std::vector<std::uint32_t>& indices, std::size_t vertex_count, std::uint32_t cache_size)
+	{
+		VertexCacheStatistics statistics;
+		if(indices.size() < 3)
+			return statistics;
+
+		// A vertex is in the cache when less than cache_size misses happened since it was loaded
+		std::vector<std::uint32_t> cache_timestamps(vertex_count, 0);
+		std::uint32_t timestamp = cache_size + 1;
+		std::size_t used_vertices = 0;
+		for(std::uint32_t index : indices)
+		{
+			if(cache_timestamps[index] == 0)
+				used_vertices++;
+			if(timestamp - cache_timestamps[index] > cache_size)
+			{
+				cache_timestamps[index] = timestamp++;
+				statistics.misses++;
+			}
+		}
+		statistics.acmr = static_cast<float>(statistics.misses) / static_cast<float>(indices.size() / 3);
+		statistics.atvr = static_cast<float>(statistics.misses) / static_cast<float>(used_vertices);
+		return statistics;
+	}
+
+	void OptimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertex_count, std::vector<std::uint32_t>* clusters, std::uint32_t cache_size)
+	{
+		if(clusters != nullptr)
+			clusters->assign(1, 0);
+		const std::size_t triangle_count = indices.size() / 3;
+		if(triangle_count == 0 || indices.size() % 3 != 0)
+			return;
+
+		// Triangles around each vertex, stored contiguously
+		std::vector<std::uint32_t> live_triangles(vertex_count, 0);
+		for(std::uint32_t index : indices)
+			live_triangles[index]++;
+		std::vector<std::uint32_t> adjacency_start(vertex_count + 1, 0);
+		for(std::size_t v = 0; v < vertex_count; v++)
+			adjacency_start[v + 1] = adjacency_start[v] + live_triangles[v];
+		std::vector<std::uint32_t> adjacency(indices.size());
+		std::vector<std::uint32_t> cursors(adjacency_start.begin(), adjacency_start.end() - 1);
+		for(std::size_t i = 0; i < indices.size(); i++)
+			adjacency[cursors[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+
+		constexpr std::uint32_t no_vertex = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> cache_timestamps(vertex_count, 0);
+		std::vector<std::uint8_t> emitted(triangle_count, 0);
+		std::vector<std::uint32_t> dead_ends;
+		std::vector<std::uint32_t> candidates;
+		std::vector<std::uint32_t> output;
+		dead_ends.reserve(indices.size());
+		output.reserve(indices.size());
+		std::uint32_t timestamp = cache_size + 1;
+		std::uint32_t input_cursor = 0;
+
+		// Emits every triangle around the fanning vertex, then fans around one of their vertices
+		for(std::uint32_t fanning = indices[0]; fanning != no_vertex;)
+		{
+			candidates.clear();
+			for(std::uint32_t a = adjacency_start[fanning]; a < adjacency_start[fanning + 1]; a++)
+			{
+				std::uint32_t triangle = adjacency[a];
+				if(emitted[triangle])
+					continue;
+				emitted[triangle] = 1;
+				for(std::size_t k = 0; k < 3; k++)
+				{
+					std::uint32_t v = indices[triangle * 3 + k];
+					output.push_back(v);
+					dead_ends.push_back(v);
+					candidates.push_back(v);
+					live_triangles[v]--;
+					if(timestamp - cache_timestamps[v] > cache_size)
+						cache_timestamps[v] = timestamp++;
+				}
+			}
+
+			// Oldest candidate that would still be cached once all its triangles are emitted
+			std::uint32_t next = no_vertex;
+			std::int64_t best_priority = -1;
+			for(std::uint32_t v : candidates)
+			{
+				if(live_triangles[v] == 0)
+					continue;
+				std::int64_t priority = 0;
+				if(timestamp - cache_timestamps[v] + 2 * live_triangles[v] <= cache_size)
+					priority = timestamp - cache_timestamps[v];
+				if(priority > best_priority)
+				{
+					best_priority = priority;
+					next = v;
+				}
+			}
+			if(next != no_vertex)
+			{
+				fanning = next;
+				continue;
+			}
+
+			// Dead end, the most recent vertex with triangles left or else the next one in input order
+			while(next == no_vertex && !dead_ends.empty())
+			{
+				if(live_triangles[dead_ends.back()] > 0)
+					next = dead_ends.back();
+				dead_ends.pop_back();
+			}
+			for(; next == no_vertex && input_cursor < vertex_count; input_cursor++)
+			{
+				if(live_triangles[input_cursor] > 0)
+					next = input_cursor;
+			}
+			if(clusters != nullptr && next != no_vertex && output.size() / 3 != clusters->back())
+				clusters->push_back(static_cast<std::uint32_t>(output.size() / 3));
+			fanning = next;
+		}
+		indices.swap(output);
+	}
+
+	void OptimizeOverdraw(std::vector<std::uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& clusters, float threshold, std::uint32_t cache_size)
+	{
+		const std::size_t triangle_count = indices.size() / 3;
+		if(triangle_count == 0 || indices.size() % 3 != 0 || clusters.empty())
+			return;
+
+		// Cache starts cold in each cluster since clusters may end up in any order
+		const float target_acmr = AnalyzeVertexCache(indices, vertices.size(), cache_size).acmr * threshold;
+		std::vector<std::uint32_t> cache_timestamps(vertices.size(), 0);
+		std::uint32_t timestamp = cache_size + 1;
+		std::vector<std::uint32_t> soft_clusters;
+		for(std::size_t c = 0; c < clusters.size(); c++)
+		{
+			std::uint32_t last = (c + 1 < clusters.size() ? clusters[c + 1] : static_cast<std::uint32_t>(triangle_count));
+			std::uint32_t cluster_start = clusters[c];
+			std::size_t misses = 0;
+			soft_clusters.push_back(cluster_start);
+			timestamp += cache_size + 1;
+			for(std::uint32_t t = clusters[c]; t < last; t++)
+			{
+				for(std::size_t k = 0; k < 3; k++)
+				{
+					std::uint32_t v = indices[t * 3 + k];
+					if(timestamp - cache_timestamps[v] > cache_size)
+					{
+						cache_timestamps[v] = timestamp++;
+						misses++;
+					}
+				}
+				if(t + 1 < last && static_cast<float>(misses) <= target_acmr * static_cast<float>(t + 1 - cluster_start))
+				{
+					cluster_start = t + 1;
+					misses = 0;
+					soft_clusters.push_back(cluster_start);
+					timestamp += cache_size + 1;
+				}
+			}
+		}
+
+		// Area weighted centroid and normal of each cluster
+		std::vector<Vec3f> centroids(soft_clusters.size(), Vec3f{ 0.0f });
+		std::vector<Vec3f> normals(soft_clusters.size(), Vec3f{ 0.0f });
+		std::vector<float> areas(soft_clusters.size(), 0.0f);
+		Vec3f mesh_centroid{ 0.0f };
+		float mesh_area = 0.0f;
+		for(std::size_t c = 0; c < soft_clusters.size(); c++)
+		{
+			std::uint32_t last = (c + 1 < soft_clusters.size() ? soft_clusters[c + 1] : static_cast<std::uint32_t>(triangle_count));
+			for(std::uint32_t t = soft_clusters[c]; t < last; t++)
+			{
+				Vec3f a{ vertices[indices[t * 3 + 0]].position };
+				Vec3f b{ vertices[indices[t * 3 + 1]].position };
+				Vec3f c_position{ vertices[indices[t * 3 + 2]].position };
+				Vec3f normal = (b - a).CrossProduct(c_position - a);
+				float area = normal.GetLength();
+				centroids[c] += (a + b + c_position) * (area / 3.0f);
+				normals[c] += normal;
+				areas[c] += area;
+			}
+			mesh_centroid += centroids[c];
+			mesh_area += areas[c];
+		}
+		if(mesh_area > 0.0f)
+			mesh_centroid /= mesh_area;
+
+		std::vector<float> keys(soft_clusters.size(), 0.0f);
+		for(std::size_t c = 0; c < soft_clusters.size(); c++)
+		{
+			float normal_length = normals[c].GetLength();
+			if(areas[c] > 0.0f && normal_length > 0.0f)
+				keys[c] = (centroids[c] / areas[c] - mesh_centroid).DotProduct(normals[c] / normal_length);
+		}
+		std::vector<std::uint32_t> order(soft_clusters.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&keys](std::uint32_t lhs, std::uint32_t rhs) { return keys[lhs] > keys[rhs]; });
+
+		std::vector<std::uint32_t> output;
+		output.reserve(indices.size());
+		for(std::uint32_t c : order)
+		{
+			std::uint32_t last = (c + 1 < soft_clusters.size() ? soft_clusters[c + 1] : static_cast<std::uint32_t>(triangle_count));
+			output.insert(output.end(), indices.begin() + soft_clusters[c] * 3, indices.begin() + last * 3);
+		}
+		indices.swap(output);
+	}
+
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices)
+	{
+		constexpr std::uint32_t no_vertex = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> remap(vertices.size(), no_vertex);
+		std::vector<Vertex> output;
+		output.reserve(vertices.size());
+		for(std::uint32_t& index : indices)
+		{
+			std::uint32_t& new_index = remap[index];
+			if(new_index == no_vertex)
+			{
+				new_index = static_cast<std::uint32_t>(output.size());
+				output.push_back(vertices[index]);
+			}
+			index = new_index;
+		}
+		vertices.swap(output);
+	}
+
+	void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices)
+	{
+		if(indices.size() % 3 != 0)
+			return;
+		std::vector<std::uint32_t> clusters;
+		OptimizeVertexCache(indices, vertices.size(), &clusters);
+		OptimizeOverdraw(indices, vertices, clusters);
+		OptimizeVertexFetch(vertices, indices);
+	}
+}
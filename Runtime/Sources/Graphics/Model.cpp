@@ -1,8 +1,13 @@
 #include <Graphics/Model.h>
 #include <Graphics/Loaders/OBJ.h>
+#include <Graphics/Loaders/SCMH.h>
+#include <Graphics/MeshOptimizer.h>
 #include <Renderer/Pipelines/Graphics.h>
+#include <Renderer/BindlessTextureTable.h>
 #include <Maths/Angles.h>
 
+#include <thread>
+#include <cstring>
 #include <unordered_map>
 
 namespace Scop
@@ -36,6 +41,19 @@ namespace Scop
 				material = m_materials.back();
 			else
 				material = m_materials[i];
+			if(pipeline.UsesBindlessTextures())
+			{
+				// No per material set, the shader fetches the material from the table set with its index
+				material->FlushData(frame_index);
+				std::uint32_t material_index = RenderCore::Get().GetMaterialTable().GetSlotElementIndex(material->GetSlot());
+				VkShaderStageFlags stages = pipeline.GetPushConstantStages(MATERIAL_INDEX_PUSH_CONSTANT_OFFSET, sizeof(std::uint32_t));
+				if(stages != 0)
+					RenderCore::Get().vkCmdPushConstants(cmd, pipeline.GetPipelineLayout(), stages, MATERIAL_INDEX_PUSH_CONSTANT_OFFSET, sizeof(std::uint32_t), &material_index);
+				std::array<VkDescriptorSet, 3> sets = { matrices_set->GetSet(frame_index), set->GetSet(frame_index), RenderCore::Get().GetBindlessTextureTable().GetSet() };
+				RenderCore::Get().vkCmdBindDescriptorSets(cmd, pipeline.GetPipelineBindPoint(), pipeline.GetPipelineLayout(), 0, sets.size(), sets.data(), 0, nullptr);
+				p_mesh->Draw(cmd, drawcalls, polygondrawn, i);
+				continue;
+			}
 			if(!material->IsSetInit())
 				material->UpdateDescriptorSet(set);
 			material->Bind(frame_index, cmd);
@@ -45,98 +63,273 @@ namespace Scop
 		}
 	}
 
-	RadianAnglef GetAngleBetweenVectors(const Vec3f& a, const Vec3f& b) noexcept
+	namespace Internal
 	{
-		float cosine_theta = (a.DotProduct(b)) / (a.GetLength() * b.GetLength());
-		RadianAnglef angle(std::acos(cosine_theta));
-		return angle;
+		Vec4f GetDebugColor(std::size_t vertex_index) noexcept
+		{
+			switch(vertex_index % 10)
+			{
+				case 0:  return Vec4f{ 1.0f, 0.0f, 1.0f, 1.0f };
+				case 1:  return Vec4f{ 1.0f, 1.0f, 0.0f, 1.0f };
+				case 2:  return Vec4f{ 1.0f, 0.5f, 0.0f, 1.0f };
+				case 3:  return Vec4f{ 1.0f, 0.0f, 0.0f, 1.0f };
+				case 4:  return Vec4f{ 0.2f, 0.0f, 0.8f, 1.0f };
+				case 5:  return Vec4f{ 0.0f, 1.0f, 1.0f, 1.0f };
+				case 6:  return Vec4f{ 0.0f, 1.0f, 0.0f, 1.0f };
+				case 7:  return Vec4f{ 0.0f, 0.0f, 1.0f, 1.0f };
+				case 8:  return Vec4f{ 0.3f, 0.0f, 0.4f, 1.0f };
+				default: return Vec4f{ 1.0f, 1.0f, 1.0f, 1.0f };
+			}
+		}
+
+		struct PositionHasher
+		{
+			std::size_t operator()(const Vec3f& position) const noexcept
+			{
+				std::size_t hash = std::hash<float>{}(position.x);
+				hash ^= std::hash<float>{}(position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				hash ^= std::hash<float>{}(position.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				return hash;
+			}
+		};
+
+		// Vertices only differing by their uv or color share a position id, so seams are smoothed too
+		std::vector<std::uint32_t> ComputePositionIds(const std::vector<Vec3f>& positions, std::uint32_t& positions_count)
+		{
+			std::unordered_map<Vec3f, std::uint32_t, PositionHasher> ids;
+			ids.reserve(positions.size());
+			std::vector<std::uint32_t> position_ids(positions.size());
+			for(std::size_t i = 0; i < positions.size(); i++)
+				position_ids[i] = ids.try_emplace(positions[i] + Vec3f{ 0.0f }, static_cast<std::uint32_t>(ids.size())).first->second; // + 0 folds -0 into 0
+			positions_count = static_cast<std::uint32_t>(ids.size());
+			return position_ids;
+		}
+
+		// One normal per face vertex, the average of the faces around its position that are within the crease angle of its own face.
+		// Linear in the number of faces for meshes of bounded valence
+		std::vector<Vec3f> GenerateSmoothNormals(const ObjModel& model, const std::vector<std::uint32_t>& faces, const std::vector<std::uint32_t>& position_ids, std::uint32_t positions_count, float crease_cosine)
+		{
+			const std::size_t triangles_count = faces.size() / 3;
+			std::vector<Vec3f> face_normals(triangles_count);
+			for(std::size_t f = 0; f < triangles_count; f++)
+			{
+				Vec3f vec_a{ model.vertex[faces[f * 3 + 1]] - model.vertex[faces[f * 3]] };
+				Vec3f vec_b{ model.vertex[faces[f * 3 + 2]] - model.vertex[faces[f * 3]] };
+				Vec3f normal = vec_a.CrossProduct(vec_b);
+				float length = normal.GetLength();
+				face_normals[f] = (length > 0.0f ? normal / length : Vec3f{ 0.0f }); // Degenerated faces do not contribute
+			}
+
+			// Faces around each position, stored contiguously
+			std::vector<std::uint32_t> adjacency_start(positions_count + 1, 0);
+			for(std::uint32_t index : faces)
+				adjacency_start[position_ids[index] + 1]++;
+			for(std::size_t p = 0; p < positions_count; p++)
+				adjacency_start[p + 1] += adjacency_start[p];
+			std::vector<std::uint32_t> adjacency(faces.size());
+			std::vector<std::uint32_t> cursors(adjacency_start.begin(), adjacency_start.end() - 1);
+			for(std::size_t i = 0; i < triangles_count * 3; i++)
+				adjacency[cursors[position_ids[faces[i]]]++] = static_cast<std::uint32_t>(i / 3);
+
+			std::vector<Vec3f> normals(faces.size(), Vec3f{ 0.0f });
+			for(std::size_t i = 0; i < triangles_count * 3; i++)
+			{
+				const Vec3f& own = face_normals[i / 3];
+				std::uint32_t position = position_ids[faces[i]];
+				Vec3f normal{ 0.0f };
+				for(std::uint32_t a = adjacency_start[position]; a < adjacency_start[position + 1]; a++)
+				{
+					const Vec3f& other = face_normals[adjacency[a]];
+					if(own.DotProduct(other) >= crease_cosine)
+						normal += other;
+				}
+				float length = normal.GetLength();
+				normals[i] = (length > 0.0f ? normal / length : own);
+			}
+			return normals;
+		}
+
+		// Sub meshes are copied from the mapped file to the staging memory without intermediate buffers
+		std::shared_ptr<Mesh> LoadMeshFromCache(const std::filesystem::path& cache_path, const std::filesystem::path& source, float build_parameter, std::uint32_t flags, Vec3f& center)
+		{
+			MappedFile file;
+			SCMHInfos infos;
+			if(!LoadSCMHFile(cache_path, file, infos))
+				return nullptr;
+			if(infos.build_parameter != build_parameter || infos.flags != flags || !IsSCMHUpToDate(infos, source))
+			{
+				Message("SCMH Loader: % is outdated", cache_path);
+				return nullptr;
+			}
+			std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+			for(const SCMHSubMesh& submesh : infos.submeshes)
+				mesh->AddSubMesh({ file.GetData() + submesh.offset, submesh.vertex_count, submesh.index_count });
+			center = (infos.aabb_min + infos.aabb_max) / 2.0f;
+			Message("SCMH Loader: loaded %", cache_path);
+			return mesh;
+		}
+
+		// Each chunk is packed in a scratch laid out like a sub mesh, copied from there to the staging memory and to the cache
+		std::shared_ptr<Mesh> LoadMeshFromObjStream(const std::filesystem::path& path, const std::filesystem::path& cache_path, float build_parameter, bool optimize, Vec3f& center)
+		{
+			const std::size_t max_indices = std::size_t(OBJ_STREAM_CHUNK_VERTICES) * OBJ_STREAM_INDICES_PER_VERTEX;
+			CPUBuffer scratch(OBJ_STREAM_CHUNK_VERTICES * sizeof(Vertex) + max_indices * sizeof(std::uint32_t));
+			std::vector<Vertex> vertices;
+			std::vector<std::uint32_t> indices;
+			std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+			SCMHWriter writer;
+			writer.Open(cache_path);
+
+			ObjStreamInfos infos;
+			bool result = StreamObjFile(path, OBJ_STREAM_CHUNK_VERTICES, infos, [&](const ObjModelChunk& chunk)
+			{
+				Vec3f extent = infos.aabb_max - infos.aabb_min;
+				vertices.clear();
+				for(std::size_t i = 0; i < chunk.vertex.size(); i++)
+				{
+					const Vec3f& position = chunk.vertex[i];
+					vertices.emplace_back(
+						Vec4f{ position, 1.0f },
+						GetDebugColor(i),
+						Vec4f{ chunk.normal[i], 1.0f },
+						(chunk.tex_coord.empty() ?
+							Vec2f{ (position.x - infos.aabb_min.x) / extent.x, 1.0f - ((position.y - infos.aabb_min.y) / extent.y) }
+							:
+							chunk.tex_coord[i]
+						)
+					);
+				}
+				indices.assign(chunk.indices.begin(), chunk.indices.end());
+				if(optimize)
+					OptimizeMesh(vertices, indices);
+
+				std::uint32_t vertex_count = static_cast<std::uint32_t>(vertices.size());
+				std::uint32_t index_count = static_cast<std::uint32_t>(indices.size());
+				std::memcpy(scratch.GetData(), vertices.data(), vertex_count * sizeof(Vertex));
+				std::memcpy(scratch.GetData() + vertex_count * sizeof(Vertex), indices.data(), index_count * sizeof(std::uint32_t));
+				mesh->AddSubMesh({ scratch.GetData(), vertex_count, index_count });
+				writer.AddSubMesh(vertices.data(), vertex_count, indices.data(), index_count);
+			});
+			if(!result)
+				return nullptr;
+			writer.Finish(ComputeSCMHSourceStamp(path, true), build_parameter, (optimize ? SCMH_FLAG_OPTIMIZED : 0), infos.aabb_min, infos.aabb_max);
+			center = (infos.aabb_min + infos.aabb_max) / 2.0f;
+			return mesh;
+		}
 	}
 
-	Model LoadModelFromObjFile(std::filesystem::path path) noexcept
+	Model LoadModelFromObjFile(std::filesystem::path path, DegreeAnglef crease_angle, bool optimize) noexcept
 	{
+		std::filesystem::path cache_path = path;
+		cache_path += ".scmh";
+		std::uint32_t cache_flags = (optimize ? SCMH_FLAG_OPTIMIZED : 0);
+		Vec3f center;
+		if(std::shared_ptr<Mesh> cached_mesh = Internal::LoadMeshFromCache(cache_path, path, crease_angle.value, cache_flags, center))
+		{
+			Model model(cached_mesh);
+			model.m_center = center;
+			return model;
+		}
+
+		// Faces of big files are never all in memory, at the cost of normals smoothed without crease
+		std::error_code error;
+		if(std::filesystem::file_size(path, error) > OBJ_STREAMING_THRESHOLD && !error)
+		{
+			std::shared_ptr<Mesh> mesh = Internal::LoadMeshFromObjStream(path, cache_path, crease_angle.value, optimize, center);
+			if(!mesh)
+				return { nullptr };
+			Model model(mesh);
+			model.m_center = center;
+			return model;
+		}
+
 		auto obj_data = LoadObjFromFile(path);
 		if(!obj_data)
 			return { nullptr };
 		TesselateObjData(*obj_data);
 		ObjModel obj_model = ConvertObjDataToObjModel(*obj_data);
-		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+		obj_data.reset();
 
 		float min_x = std::numeric_limits<float>::max(), max_x = std::numeric_limits<float>::lowest();
 		float min_y = std::numeric_limits<float>::max(), max_y = std::numeric_limits<float>::lowest();
 		float min_z = std::numeric_limits<float>::max(), max_z = std::numeric_limits<float>::lowest();
+		for(const Vec3f& vertex : obj_model.vertex)
+		{
+			min_x = std::min(vertex.x, min_x);
+			min_y = std::min(vertex.y, min_y);
+			min_z = std::min(vertex.z, min_z);
+			max_x = std::max(vertex.x, max_x);
+			max_y = std::max(vertex.y, max_y);
+			max_z = std::max(vertex.z, max_z);
+		}
 
 		bool needs_to_generate_normals = obj_model.normal.empty();
 		std::unordered_map<std::string, std::vector<Vec3f>> generated_normals;
 		if(needs_to_generate_normals)
 		{
+			std::uint32_t positions_count;
+			std::vector<std::uint32_t> position_ids = Internal::ComputePositionIds(obj_model.vertex, positions_count);
+			float crease_cosine = crease_angle.GetCos();
+			for(auto& [group, _] : obj_model.faces)
+				generated_normals[group];
+
+			// Groups are independent, the map is not modified anymore while the workers run
+			std::vector<std::thread> workers;
+			std::size_t workers_limit = std::max(std::thread::hardware_concurrency(), 1u);
 			for(auto& [group, faces] : obj_model.faces)
 			{
-				generated_normals[group] = std::vector<Vec3f>(faces.size(), Vec3f{});
-				for(std::size_t i = 0; i < faces.size(); i += 3)
+				if(workers.size() == workers_limit)
 				{
-					Vec3f vec_a{ obj_model.vertex[faces[i + 1]] - obj_model.vertex[faces[i]] };
-					Vec3f vec_b{ obj_model.vertex[faces[i + 2]] - obj_model.vertex[faces[i]] };
-					Vec3f normal = vec_a.CrossProduct(vec_b).Normalize();
-					generated_normals[group][i + 0] = normal;
-					generated_normals[group][i + 1] = normal;
-					generated_normals[group][i + 2] = normal;
+					for(std::thread& worker : workers)
+						worker.join();
+					workers.clear();
 				}
+				workers.emplace_back([&, &faces = faces, &normals = generated_normals[group]]()
+				{
+					normals = Internal::GenerateSmoothNormals(obj_model, faces, position_ids, positions_count, crease_cosine);
+				});
 			}
+			for(std::thread& worker : workers)
+				worker.join();
 		}
 
+		constexpr std::uint32_t no_vertex = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> local_indices(obj_model.vertex.size());
+		std::size_t vertices_count = 0;
+		std::size_t indices_count = 0;
+		std::vector<SCMHSubMeshData> submeshes;
+		submeshes.reserve(obj_model.faces.size());
 		for(auto& [group, faces] : obj_model.faces)
 		{
-			std::vector<Vertex> vertices;
-			std::vector<std::uint32_t> indices;
+			// Model vertices are shared between groups, each sub mesh gets its own compact vertex buffer
+			std::fill(local_indices.begin(), local_indices.end(), no_vertex);
+			std::vector<Vertex>& vertices = submeshes.emplace_back().vertices;
+			std::vector<std::uint32_t>& indices = submeshes.back().indices;
+			indices.reserve(faces.size());
 			for(std::size_t i = 0; i < faces.size(); i++)
 			{
-				min_x = std::min(obj_model.vertex[faces[i]].x, min_x);
-				min_y = std::min(obj_model.vertex[faces[i]].y, min_y);
-				min_z = std::min(obj_model.vertex[faces[i]].z, min_z);
-				max_x = std::max(obj_model.vertex[faces[i]].x, max_x);
-				max_y = std::max(obj_model.vertex[faces[i]].y, max_y);
-				max_z = std::max(obj_model.vertex[faces[i]].z, max_z);
-
-				Vec4f color{};
-				switch(i % 10)
-				{
-					case 0:  color = Vec4f{ 1.0f, 0.0f, 1.0f, 1.0f }; break;
-					case 1:  color = Vec4f{ 1.0f, 1.0f, 0.0f, 1.0f }; break;
-					case 2:  color = Vec4f{ 1.0f, 0.5f, 0.0f, 1.0f }; break;
-					case 3:  color = Vec4f{ 1.0f, 0.0f, 0.0f, 1.0f }; break;
-					case 4:  color = Vec4f{ 0.2f, 0.0f, 0.8f, 1.0f }; break;
-					case 5:  color = Vec4f{ 0.0f, 1.0f, 1.0f, 1.0f }; break;
-					case 6:  color = Vec4f{ 0.0f, 1.0f, 0.0f, 1.0f }; break;
-					case 7:  color = Vec4f{ 0.0f, 0.0f, 1.0f, 1.0f }; break;
-					case 8:  color = Vec4f{ 0.3f, 0.0f, 0.4f, 1.0f }; break;
-					default: color = Vec4f{ 1.0f, 1.0f, 1.0f, 1.0f }; break;
-				}
-
 				Vec3f normal{};
 				if(needs_to_generate_normals)
-				{
 					normal = generated_normals[group][i];
-					for(std::size_t j = 0; j < faces.size(); j++)
-					{
-						if(faces[j] == faces[i] && i != j)
-						{
-							RadianAnglef angle = GetAngleBetweenVectors(generated_normals[group][i], generated_normals[group][j]);
-							if(angle.ToDegrees() < 89.0f)
-								normal += generated_normals[group][j];
-						}
-					}
-				}
 				else
-					normal = obj_model.normal[faces[i]];
+					normal = obj_model.normal[faces[i]].GetNormal();
+
+				// Generated normals may differ between the corners sharing a position, those get their own vertex
+				std::uint32_t& local_index = local_indices[faces[i]];
+				if(local_index != no_vertex && (!needs_to_generate_normals || Vec3f{ vertices[local_index].normal } == normal))
+				{
+					indices.push_back(local_index);
+					continue;
+				}
 
 				Vertex v(
 					Vec4f{
 						obj_model.vertex[faces[i]],
 						1.0f
 					},
-					color,
+					Internal::GetDebugColor(vertices.size()),
 					Vec4f{
-						normal.Normalize(),
+						normal,
 						1.0f
 					},
 					(obj_model.tex_coord.empty() ?
@@ -145,14 +338,27 @@ namespace Scop
 						obj_model.tex_coord[faces[i]]
 					)
 				);
-				indices.push_back(vertices.size());
+				local_index = static_cast<std::uint32_t>(vertices.size());
+				indices.push_back(local_index);
 				vertices.push_back(std::move(v));
 			}
 
-			mesh->AddSubMesh({ vertices, indices });
+			if(optimize)
+				OptimizeMesh(vertices, indices);
+			vertices_count += vertices.size();
+			indices_count += indices.size();
 		}
+		Message("OBJ Loader : % vertices for % indices in %", vertices_count, indices_count, path);
+
+		Vec3f aabb_min{ min_x, min_y, min_z };
+		Vec3f aabb_max{ max_x, max_y, max_z };
+		WriteSCMHFile(cache_path, ComputeSCMHSourceStamp(path, true), crease_angle.value, cache_flags, aabb_min, aabb_max, submeshes);
+
+		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+		for(const SCMHSubMeshData& submesh : submeshes)
+			mesh->AddSubMesh({ submesh.vertices, submesh.indices });
 		Model model(mesh);
-		model.m_center = Vec3f{ (min_x + max_x) / 2.0f, (min_y + max_y) / 2.0f, (min_z + max_z) / 2.0f };
+		model.m_center = (aabb_min + aabb_max) / 2.0f;
 		return model;
 	}
 }
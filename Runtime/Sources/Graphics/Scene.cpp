@@ -1,6 +1,7 @@
 #include <Graphics/Scene.h>
 #include <Renderer/Renderer.h>
 #include <Renderer/RenderCore.h>
+#include <Renderer/BindlessTextureTable.h>
 #include <Platform/Inputs.h>
 #include <Core/Logs.h>
 #include <Renderer/ViewerData.h>
@@ -153,19 +154,31 @@ namespace Scop
 		{
 			if(event.What() == Event::ResizeEventCode)
 			{
-				m_depth.Destroy();
-				m_depth.Init(renderer->GetSwapchain().GetSwapchainImages().back().GetWidth(), renderer->GetSwapchain().GetSwapchainImages().back().GetHeight(), false, m_name + "_depth");
-				m_depth.CreateSampler();
+				std::uint32_t width = renderer->GetSwapchain().GetSwapchainImages().back().GetWidth();
+				std::uint32_t height = renderer->GetSwapchain().GetSwapchainImages().back().GetHeight();
+				if(m_depth.GetWidth() != width || m_depth.GetHeight() != height)
+				{
+					m_depth.Destroy();
+					m_depth.Init(width, height, false, m_name + "_depth");
+					m_depth.CreateSampler();
+				}
+				// Pipelines only depend on attachments formats, only their framebuffers need to follow the new size
+				m_pipeline.InvalidateFramebuffers();
+				for(auto& [_, actor] : m_actors)
+				{
+					if(actor.m_custom_pipeline.has_value() && actor.m_custom_pipeline->pipeline)
+						actor.m_custom_pipeline->pipeline->InvalidateFramebuffers();
+				}
 			}
 
-			if(event.What() == Event::ResizeEventCode || event.What() == Event::SceneHasChangedEventCode)
+			if(event.What() == Event::SceneHasChangedEventCode)
 				m_pipeline.Destroy(); // Ugly but f*ck off
 		};
 		EventBus::RegisterListener({ functor, m_name + std::to_string(reinterpret_cast<std::uintptr_t>(this)) });
 
 		if(m_descriptor.post_process_shader)
 		{
-			m_post_process.set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(m_descriptor.post_process_shader->GetShaderLayout().set_layouts.at(0), ShaderType::Fragment);
+			m_post_process.set.Init(m_descriptor.post_process_shader->GetShaderLayout().set_layouts.at(0), ShaderType::Fragment);
 			m_post_process.data_buffer = std::make_shared<UniformBuffer>();
 			m_post_process.data_buffer->Init(m_descriptor.post_process_data_size, m_name + "_post_process_data_buffer");
 		}
@@ -184,7 +197,13 @@ namespace Scop
 			m_forward.matrices_set->SetUniformBuffer(i, 0, m_forward.matrices_buffer->Get(i));
 			m_forward.matrices_set->Update(i);
 		}
-		m_forward.albedo_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(m_descriptor.fragment_shader->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
+		if(RenderCore::Get().IsBindlessEnabled())
+			m_forward.material_table_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(RenderCore::Get().GetDefaultFragmentShader()->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
+		// Bindless shaders have no per material set, custom pipelines that still need one get the default layout
+		if(RenderCore::Get().IsBindlessEnabled() && m_descriptor.fragment_shader->GetShaderLayout().set_layouts.contains(BINDLESS_TEXTURE_SET))
+			m_forward.albedo_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(DefaultShaderLayout.set_layouts.at(1), ShaderType::Fragment);
+		else
+			m_forward.albedo_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(m_descriptor.fragment_shader->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
 
 		for(auto& child : m_scene_children)
 			child.Init(renderer);
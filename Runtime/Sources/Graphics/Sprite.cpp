@@ -1,7 +1,6 @@
 #include <Graphics/Sprite.h>
 #include <Core/Script.h>
 #include <Renderer/Image.h>
-#include <Graphics/MeshFactory.h>
 #include <Core/Logs.h>
 #include <Core/UUID.h>
 
@@ -11,7 +10,6 @@ namespace Scop
 	{
 		Verify((bool)texture, "Sprite: invalid texture");
 		m_uuid = UUID();
-		p_mesh = CreateQuad(0, 0, texture->GetWidth(), texture->GetHeight());
 		p_texture = texture;
 		if(p_script)
 			p_script->OnInit(this);
@@ -21,7 +19,6 @@ namespace Scop
 	{
 		Verify((bool)texture, "Sprite: invalid texture");
 		m_uuid = uuid;
-		p_mesh = CreateQuad(0, 0, texture->GetWidth(), texture->GetHeight());
 		p_texture = texture;
 		if(p_script)
 			p_script->OnInit(this);
@@ -1,48 +1,164 @@
 #include <Graphics/Text.h>
+#include <Graphics/GlyphCache.h>
+#include <Renderer/RenderCore.h>
 #include <Renderer/Vertex.h>
+#include <Core/Logs.h>
 
+#include <cmath>
 #include <vector>
+#include <algorithm>
 
 namespace Scop
 {
+	namespace Internal
+	{
+		// Invalid sequences decode as U+FFFD
+		std::uint32_t DecodeUTF8(const std::string& text, std::size_t& i) noexcept
+		{
+			constexpr std::uint32_t replacement = 0xFFFD;
+			std::uint8_t lead = static_cast<std::uint8_t>(text[i++]);
+			if(lead < 0x80)
+				return lead;
+			std::size_t length;
+			std::uint32_t codepoint;
+			if((lead & 0xE0) == 0xC0)
+			{
+				length = 1;
+				codepoint = lead & 0x1F;
+			}
+			else if((lead & 0xF0) == 0xE0)
+			{
+				length = 2;
+				codepoint = lead & 0x0F;
+			}
+			else if((lead & 0xF8) == 0xF0)
+			{
+				length = 3;
+				codepoint = lead & 0x07;
+			}
+			else
+				return replacement;
+			for(std::size_t j = 0; j < length; j++, i++)
+			{
+				if(i >= text.size() || (static_cast<std::uint8_t>(text[i]) & 0xC0) != 0x80)
+					return replacement;
+				codepoint = (codepoint << 6) | (static_cast<std::uint8_t>(text[i]) & 0x3F);
+			}
+			return codepoint;
+		}
+	}
+
 	Text::Text(std::uint64_t uuid, const std::string& text, std::shared_ptr<Font> font) : m_uuid(uuid)
 	{
 		Assert(font != nullptr, "invalid font");
+		p_font = font;
+		m_text = text;
+		BuildMesh();
+	}
 
-		std::vector<Vertex> vertex_data;
-		std::vector<std::uint32_t> index_data;
+	void Text::SetText(const std::string& text)
+	{
+		if(text == m_text)
+			return;
+		m_text = text;
+		BuildMesh();
+	}
 
-		float stb_x = 0.0f;
-		float stb_y = 0.0f;
+	void Text::BuildMesh()
+	{
+		GlyphCache& cache = RenderCore::Get().GetGlyphCache();
+
+		m_glyph_quads.clear();
+		m_page_scratch.clear();
 
-		const auto& char_data = font->GetCharData();
-		for(char c : text)
+		float pen_x = 0.0f;
+		std::uint32_t previous = 0;
+		if(!p_font->IsBuilt())
+			Error("Text: font % is not loaded", p_font->GetName());
+		for(std::size_t i = 0; p_font->IsBuilt() && i < m_text.size();)
 		{
-			if(c < 32)
+			std::uint32_t codepoint = Internal::DecodeUTF8(m_text, i);
+			if(codepoint < 32)
+				continue;
+			if(previous != 0)
+				pen_x += p_font->GetKerning(previous, codepoint);
+			previous = codepoint;
+
+			const Glyph* glyph = cache.GetGlyph(*p_font, codepoint);
+			if(glyph == nullptr)
 				continue;
+			if(glyph->page != GLYPH_CACHE_NO_PAGE)
+			{
+				if(std::find(m_page_scratch.begin(), m_page_scratch.end(), glyph->page) == m_page_scratch.end())
+					m_page_scratch.push_back(glyph->page);
 
-			stbtt_aligned_quad q;
-			stbtt_GetPackedQuad(char_data.data(), RANGE, RANGE, c - 32, &stb_x, &stb_y, &q, 1);
+				float x0 = std::floor(pen_x + 0.5f) + glyph->offset.x;
+				float y0 = glyph->offset.y;
+				float x1 = x0 + glyph->size.x;
+				float y1 = y0 + glyph->size.y;
 
-			std::size_t index = vertex_data.size();
+				GlyphQuad& glyph_quad = m_glyph_quads.emplace_back();
+				glyph_quad.page = glyph->page;
+				glyph_quad.quad[0] = Vertex{ Vec4f{ x0, y0, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ glyph->uv_min.x, -glyph->uv_min.y } };
+				glyph_quad.quad[1] = Vertex{ Vec4f{ x1, y0, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ glyph->uv_max.x, -glyph->uv_min.y } };
+				glyph_quad.quad[2] = Vertex{ Vec4f{ x1, y1, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ glyph->uv_max.x, -glyph->uv_max.y } };
+				glyph_quad.quad[3] = Vertex{ Vec4f{ x0, y1, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ glyph->uv_min.x, -glyph->uv_max.y } };
+			}
+			pen_x += glyph->advance;
+		}
+		cache.Flush();
 
-			vertex_data.emplace_back(Vec4f{ q.x0, q.y0, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ q.s0, -q.t0 });
-			vertex_data.emplace_back(Vec4f{ q.x1, q.y0, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ q.s1, -q.t0 });
-			vertex_data.emplace_back(Vec4f{ q.x1, q.y1, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ q.s1, -q.t1 });
-			vertex_data.emplace_back(Vec4f{ q.x0, q.y1, 0.0f, 1.0f }, Vec4f{ 1.0f }, -Vec2f{ q.s0, -q.t1 });
+		m_pages.clear();
+		for(std::uint32_t index : m_page_scratch)
+			m_pages.push_back(Page{ index, cache.GetPageGeneration(index), 0, 0 });
 
-			index_data.push_back(index + 0);
-			index_data.push_back(index + 1);
-			index_data.push_back(index + 2);
-			index_data.push_back(index + 2);
-			index_data.push_back(index + 3);
-			index_data.push_back(index + 0);
+		// Quads are grouped by page so each page merges into a single batch, glyphs keep their order inside a page
+		for(const GlyphQuad& glyph_quad : m_glyph_quads)
+		{
+			for(Page& page : m_pages)
+			{
+				if(page.index == glyph_quad.page)
+				{
+					page.quad_count++;
+					break;
+				}
+			}
+		}
+		std::uint32_t first_quad = 0;
+		m_page_scratch.clear();
+		for(Page& page : m_pages)
+		{
+			page.first_quad = first_quad;
+			m_page_scratch.push_back(first_quad);
+			first_quad += page.quad_count;
 		}
 
-		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
-		mesh->AddSubMesh({ std::move(vertex_data), std::move(index_data) });
-		p_mesh = mesh;
-		p_font = font;
-		m_text = text;
+		m_quads.resize(m_glyph_quads.size());
+		for(const GlyphQuad& glyph_quad : m_glyph_quads)
+		{
+			for(std::size_t i = 0; i < m_pages.size(); i++)
+			{
+				if(m_pages[i].index == glyph_quad.page)
+				{
+					m_quads[m_page_scratch[i]++] = glyph_quad.quad;
+					break;
+				}
+			}
+		}
+	}
+
+	void Text::Prepare()
+	{
+		GlyphCache& cache = RenderCore::Get().GetGlyphCache();
+		for(const Page& page : m_pages)
+		{
+			if(page.generation != cache.GetPageGeneration(page.index))
+			{
+				BuildMesh();
+				break;
+			}
+		}
+		for(const Page& page : m_pages)
+			cache.MarkPageUsed(page.index);
 	}
 }
@@ -0,0 +1,90 @@
+#include <Graphics/TextureAtlas.h>
+#include <Graphics/Loaders/BMP.h>
+#include <Core/Logs.h>
+
+#include <cstring>
+#include <algorithm>
+
+namespace Scop
+{
+	std::uint32_t TextureAtlas::AddImage(CPUBuffer pixels, std::uint32_t width, std::uint32_t height)
+	{
+		Verify(width != 0 && height != 0 && pixels.GetSize() == std::size_t(width) * height * 4, "Texture atlas: image is empty or not RGBA8");
+		m_images.push_back(PendingImage{ std::move(pixels), width, height });
+		return static_cast<std::uint32_t>(m_images.size() - 1);
+	}
+
+	std::uint32_t TextureAtlas::AddImage(const std::filesystem::path& path)
+	{
+		Vec2ui32 dimensions;
+		CPUBuffer pixels = LoadBMPFile(path, dimensions);
+		return AddImage(std::move(pixels), dimensions.x, dimensions.y);
+	}
+
+	bool TextureAtlas::Build(std::string_view name)
+	{
+		std::vector<Vec2ui> sizes(m_images.size());
+		for(std::size_t i = 0; i < m_images.size(); i++)
+			sizes[i] = Vec2ui{ m_images[i].width + 2 * TEXTURE_ATLAS_PADDING, m_images[i].height + 2 * TEXTURE_ATLAS_PADDING };
+		std::vector<AtlasRect> rects;
+		std::uint32_t page_count;
+		if(!PackAtlasRects(sizes, m_page_size, rects, page_count))
+		{
+			Error("Texture atlas: an image does not fit in a %x% page", m_page_size, m_page_size);
+			return false;
+		}
+
+		std::vector<CPUBuffer> pages(page_count);
+		for(CPUBuffer& page : pages)
+		{
+			page = CPUBuffer(std::size_t(m_page_size) * m_page_size * 4);
+			std::memset(page.GetData(), 0, page.GetSize());
+		}
+
+		const float texel = 1.0f / static_cast<float>(m_page_size);
+		std::vector<std::shared_ptr<Texture>> textures(page_count);
+		for(std::uint32_t i = 0; i < page_count; i++)
+			textures[i] = std::make_shared<Texture>();
+
+		m_regions.resize(m_images.size());
+		for(std::size_t i = 0; i < m_images.size(); i++)
+		{
+			const PendingImage& image = m_images[i];
+			const AtlasRect& rect = rects[i];
+			std::uint8_t* page = pages[rect.page].GetData();
+			std::size_t row_size = std::size_t(image.width) * 4;
+			std::size_t page_row_size = std::size_t(m_page_size) * 4;
+
+			// Borders are extruded into the padding so filtering never reads a neighbour
+			for(std::uint32_t y = 0; y < image.height + 2 * TEXTURE_ATLAS_PADDING; y++)
+			{
+				std::uint32_t source_y = std::min(std::max(y, TEXTURE_ATLAS_PADDING) - TEXTURE_ATLAS_PADDING, image.height - 1);
+				const std::uint8_t* source = image.pixels.GetData() + source_y * row_size;
+				std::uint8_t* destination = page + (rect.y + y) * page_row_size + std::size_t(rect.x) * 4;
+				for(std::uint32_t x = 0; x < TEXTURE_ATLAS_PADDING; x++)
+				{
+					std::memcpy(destination + x * 4, source, 4);
+					std::memcpy(destination + (TEXTURE_ATLAS_PADDING + image.width + x) * 4, source + row_size - 4, 4);
+				}
+				std::memcpy(destination + TEXTURE_ATLAS_PADDING * 4, source, row_size);
+			}
+
+			m_regions[i].texture = textures[rect.page];
+			m_regions[i].uv_min = Vec2f{ static_cast<float>(rect.x + TEXTURE_ATLAS_PADDING), static_cast<float>(rect.y + TEXTURE_ATLAS_PADDING) } * texel;
+			m_regions[i].uv_max = m_regions[i].uv_min + Vec2f{ static_cast<float>(image.width), static_cast<float>(image.height) } * texel;
+		}
+
+		m_pages = std::move(textures);
+		for(std::uint32_t i = 0; i < page_count; i++)
+			m_pages[i]->Init(std::move(pages[i]), m_page_size, m_page_size, VK_FORMAT_R8G8B8A8_SRGB, false, std::string{ name } + "_page_" + std::to_string(i));
+		Message("Texture atlas: packed % images in % pages", m_images.size(), page_count);
+		return true;
+	}
+
+	void TextureAtlas::Destroy() noexcept
+	{
+		m_regions.clear();
+		m_pages.clear();
+		m_images.clear();
+	}
+}
@@ -0,0 +1,82 @@
+#include <Platform/MappedFile.h>
+#include <Core/Logs.h>
+
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Scop
+{
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if(this == &other)
+			return *this;
+		Close();
+		p_data = std::exchange(other.p_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_fd = std::exchange(other.m_fd, -1);
+		return *this;
+	}
+
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+		m_fd = open(path.c_str(), O_RDONLY);
+		if(m_fd == -1)
+		{
+			Error("Mapped file: could not open %", path);
+			return false;
+		}
+		struct stat infos;
+		if(fstat(m_fd, &infos) == -1)
+		{
+			Error("Mapped file: could not stat %", path);
+			Close();
+			return false;
+		}
+		m_size = static_cast<std::size_t>(infos.st_size);
+		if(m_size == 0) // Empty files cannot be mapped
+			return true;
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if(data == MAP_FAILED)
+		{
+			Error("Mapped file: could not map %", path);
+			Close();
+			return false;
+		}
+		madvise(data, m_size, MADV_SEQUENTIAL);
+		p_data = static_cast<const char*>(data);
+		return true;
+	}
+
+	void MappedFile::Release(const char* begin, const char* end) noexcept
+	{
+		if(p_data == nullptr || begin >= end)
+			return;
+		// Only whole pages inside the range can be dropped
+		std::uintptr_t page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+		std::uintptr_t first = (reinterpret_cast<std::uintptr_t>(begin) + page_size - 1) / page_size * page_size;
+		std::uintptr_t last = reinterpret_cast<std::uintptr_t>(end) / page_size * page_size;
+		if(first < last)
+			madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+	}
+
+	void MappedFile::Close() noexcept
+	{
+		if(p_data != nullptr)
+			munmap(const_cast<char*>(p_data), m_size);
+		if(m_fd != -1)
+			close(m_fd);
+		p_data = nullptr;
+		m_size = 0;
+		m_fd = -1;
+	}
+}
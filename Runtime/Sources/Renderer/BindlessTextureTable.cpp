@@ -0,0 +1,125 @@
+#include <Renderer/BindlessTextureTable.h>
+#include <Renderer/RenderCore.h>
+#include <Renderer/Image.h>
+#include <Core/Logs.h>
+
+#include <algorithm>
+
+namespace Scop
+{
+	void BindlessTextureTable::Init(std::uint32_t capacity)
+	{
+		m_capacity = capacity;
+
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = m_capacity;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		binding.pImmutableSamplers = nullptr;
+
+		VkDescriptorBindingFlagsEXT binding_flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+		VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info{};
+		binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+		binding_flags_info.bindingCount = 1;
+		binding_flags_info.pBindingFlags = &binding_flags;
+
+		VkDescriptorSetLayoutCreateInfo layout_info{};
+		layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layout_info.pNext = &binding_flags_info;
+		layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		layout_info.bindingCount = 1;
+		layout_info.pBindings = &binding;
+		kvfCheckVk(RenderCore::Get().vkCreateDescriptorSetLayout(RenderCore::Get().GetDevice(), &layout_info, nullptr, &m_layout));
+
+		VkDescriptorPoolSize pool_size{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_capacity };
+		VkDescriptorPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+		pool_info.maxSets = 1;
+		pool_info.poolSizeCount = 1;
+		pool_info.pPoolSizes = &pool_size;
+		kvfCheckVk(RenderCore::Get().vkCreateDescriptorPool(RenderCore::Get().GetDevice(), &pool_info, nullptr, &m_pool));
+
+		VkDescriptorSetAllocateInfo alloc_info{};
+		alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		alloc_info.descriptorPool = m_pool;
+		alloc_info.descriptorSetCount = 1;
+		alloc_info.pSetLayouts = &m_layout;
+		kvfCheckVk(RenderCore::Get().vkAllocateDescriptorSets(RenderCore::Get().GetDevice(), &alloc_info, &m_set));
+
+		Message("Vulkan: bindless texture table created (% slots)", m_capacity);
+	}
+
+	std::uint32_t BindlessTextureTable::Register(const Image& image)
+	{
+		if(image.GetImageView() == VK_NULL_HANDLE)
+			return BINDLESS_INVALID_INDEX;
+		std::uint32_t index;
+		if(!m_free_indices.empty())
+		{
+			index = m_free_indices.back();
+			m_free_indices.pop_back();
+		}
+		else if(m_next_index < m_capacity)
+			index = m_next_index++;
+		else
+		{
+			Warning("Vulkan: bindless texture table is full");
+			return BINDLESS_INVALID_INDEX;
+		}
+
+		VkDescriptorImageInfo image_info{};
+		image_info.sampler = image.GetSampler();
+		image_info.imageView = image.GetImageView();
+		image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_set;
+		write.dstBinding = 0;
+		write.dstArrayElement = index;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo = &image_info;
+		RenderCore::Get().vkUpdateDescriptorSets(RenderCore::Get().GetDevice(), 1, &write, 0, nullptr);
+		return index;
+	}
+
+	void BindlessTextureTable::Release(std::uint32_t index) noexcept
+	{
+		// Slots are partially bound, a released slot is simply never sampled until it is given to another texture
+		if(index != BINDLESS_INVALID_INDEX)
+			m_retired_indices.emplace_back(index, m_frame);
+	}
+
+	void BindlessTextureTable::Update()
+	{
+		m_frame++;
+		// Every frame that could have sampled a slot retired MAX_FRAMES_IN_FLIGHT frames ago has completed
+		auto it = std::remove_if(m_retired_indices.begin(), m_retired_indices.end(), [this](const std::pair<std::uint32_t, std::uint64_t>& retired)
+		{
+			if(retired.second + MAX_FRAMES_IN_FLIGHT > m_frame)
+				return false;
+			m_free_indices.push_back(retired.first);
+			return true;
+		});
+		m_retired_indices.erase(it, m_retired_indices.end());
+	}
+
+	void BindlessTextureTable::Destroy() noexcept
+	{
+		if(m_pool != VK_NULL_HANDLE)
+			RenderCore::Get().vkDestroyDescriptorPool(RenderCore::Get().GetDevice(), m_pool, nullptr);
+		if(m_layout != VK_NULL_HANDLE)
+			kvfDestroyDescriptorSetLayout(RenderCore::Get().GetDevice(), m_layout);
+		m_pool = VK_NULL_HANDLE;
+		m_layout = VK_NULL_HANDLE;
+		m_set = VK_NULL_HANDLE;
+		m_free_indices.clear();
+		m_retired_indices.clear();
+		m_frame = 0;
+		m_next_index = 0;
+		Message("Vulkan: bindless texture table destroyed");
+	}
+}
@@ -6,9 +6,16 @@ namespace Scop
 {
 	void GPUBuffer::Init(BufferType type, VkDeviceSize size, VkBufferUsageFlags usage, CPUBuffer data, std::string_view name, bool dedicated_alloc)
 	{
+		InitFromMemory(type, size, usage, data.GetData(), data.GetSize(), std::move(name), dedicated_alloc);
+	}
+
+	void GPUBuffer::InitFromMemory(BufferType type, VkDeviceSize size, VkBufferUsageFlags usage, const void* data, std::size_t data_size, std::string_view name, bool dedicated_alloc)
+	{
+		if(data == nullptr)
+			data_size = 0;
 		if(type == BufferType::Constant)
 		{
-			if(data.Empty())
+			if(data_size == 0)
 			{
 				Warning("Vulkan: trying to create constant buffer without data (constant buffers cannot be modified after creation)");
 				return;
@@ -27,15 +34,15 @@ namespace Scop
 			m_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 		}
 
-		if(type == BufferType::Staging && data.Empty())
+		if(type == BufferType::Staging && data_size == 0)
 			Warning("Vulkan: trying to create staging buffer without data (wtf?)");
 
 		CreateBuffer(size, m_usage, m_flags, std::move(name), dedicated_alloc);
 
-		if(!data.Empty())
+		if(data_size != 0)
 		{
 			if(m_memory.map != nullptr)
-				std::memcpy(m_memory.map, data.GetData(), data.GetSize());
+				std::memcpy(m_memory.map, data, data_size);
 		}
 		if(type == BufferType::Constant || type == BufferType::LowDynamic)
 			PushToGPU();
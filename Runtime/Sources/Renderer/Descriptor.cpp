@@ -7,11 +7,13 @@
 #include <Renderer/Buffer.h>
 #include <Renderer/RenderCore.h>
 #include <Renderer/Descriptor.h>
-#include <Renderer/RenderCore.h>
+#include <Renderer/Pipelines/DescriptorSetLayoutCache.h>
 
 namespace Scop
 {
 	constexpr std::size_t MAX_SETS_PER_POOL = MAX_FRAMES_IN_FLIGHT * 1024;
+	constexpr std::uint32_t MAX_TRANSIENT_SETS_PER_POOL = 1024;
+	constexpr std::size_t MAX_DESCRIPTORS_PER_SET = 16;
 
 	void TransitionImageToCorrectLayout(Image& image, VkCommandBuffer cmd)
 	{
@@ -25,6 +27,122 @@ namespace Scop
 			Error("Vulkan: cannot transition descriptor image layout, unkown image type");
 	}
 
+	namespace Internal
+	{
+		VkShaderStageFlagBits ShaderTypeToVulkanStage(ShaderType shader_type)
+		{
+			switch(shader_type)
+			{
+				case ShaderType::Vertex: return VK_SHADER_STAGE_VERTEX_BIT;
+				case ShaderType::Fragment: return VK_SHADER_STAGE_FRAGMENT_BIT;
+
+				default: FatalError("wtf"); return VK_SHADER_STAGE_VERTEX_BIT; /* Just to shut up warnings */
+			}
+		}
+
+		std::vector<Descriptor> MakeDescriptors(const ShaderSetLayout& layout)
+		{
+			std::vector<Descriptor> descriptors;
+			for(auto& [binding, type] : layout.binds)
+			{
+				descriptors.emplace_back();
+				descriptors.back().type = type;
+				descriptors.back().binding = binding;
+			}
+			return descriptors;
+		}
+
+		Descriptor* FindDescriptor(std::vector<Descriptor>& descriptors, std::uint32_t binding, VkDescriptorType type)
+		{
+			auto it = std::find_if(descriptors.begin(), descriptors.end(), [=](const Descriptor& descriptor)
+			{
+				return binding == descriptor.binding;
+			});
+			bool is_image = (type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+			if(it == descriptors.end())
+			{
+				Warning("Vulkan: cannot update descriptor set %; invalid binding", is_image ? "image" : "buffer");
+				return nullptr;
+			}
+			if(it->type != type)
+			{
+				Error("Vulkan: trying to bind % to the wrong descriptor", is_image ? "an image" : "a buffer");
+				return nullptr;
+			}
+			return &*it;
+		}
+
+		// Transitions bound images and records everything a write would put in the set, returns true if it differs from written
+		bool PrepareDescriptors(std::vector<Descriptor>& descriptors, VkCommandBuffer cmd, std::vector<WrittenDescriptor>& written)
+		{
+			bool changed = (written.size() != descriptors.size());
+			written.resize(descriptors.size());
+			for(std::size_t i = 0; i < descriptors.size(); i++)
+			{
+				Descriptor& descriptor = descriptors[i];
+				WrittenDescriptor current;
+				if(descriptor.image_ptr)
+				{
+					TransitionImageToCorrectLayout(*descriptor.image_ptr, cmd);
+					current.image_view = descriptor.image_ptr->GetImageView();
+					current.sampler = descriptor.image_ptr->GetSampler();
+					current.image_layout = descriptor.image_ptr->GetLayout();
+					current.image_generation = descriptor.image_ptr->GetGeneration();
+				}
+				else if(descriptor.uniform_buffer_ptr || descriptor.storage_buffer_ptr)
+				{
+					GPUBuffer& buffer = descriptor.uniform_buffer_ptr ? *descriptor.uniform_buffer_ptr : *descriptor.storage_buffer_ptr;
+					current.buffer = buffer.Get();
+					current.buffer_offset = buffer.GetOffset() + descriptor.buffer_offset;
+					current.buffer_range = descriptor.buffer_range;
+				}
+				else
+					FatalError("unknown descriptor data");
+				if(written[i] == current)
+					continue;
+				written[i] = current;
+				changed = true;
+			}
+			return changed;
+		}
+
+		void WriteDescriptors(VkDescriptorSet set, const std::vector<Descriptor>& descriptors)
+		{
+			Verify(descriptors.size() <= MAX_DESCRIPTORS_PER_SET, "too many descriptors in a set");
+
+			std::array<VkWriteDescriptorSet, MAX_DESCRIPTORS_PER_SET> writes;
+			std::array<VkDescriptorBufferInfo, MAX_DESCRIPTORS_PER_SET> buffer_infos;
+			std::array<VkDescriptorImageInfo, MAX_DESCRIPTORS_PER_SET> image_infos;
+
+			for(std::size_t i = 0; i < descriptors.size(); i++)
+			{
+				const Descriptor& descriptor = descriptors[i];
+				if(descriptor.image_ptr)
+				{
+					image_infos[i].sampler = descriptor.image_ptr->GetSampler();
+					image_infos[i].imageLayout = descriptor.image_ptr->GetLayout();
+					image_infos[i].imageView = descriptor.image_ptr->GetImageView();
+					writes[i] = kvfWriteImageToDescriptorSet(RenderCore::Get().GetDevice(), set, &image_infos[i], descriptor.binding);
+				}
+				else if(descriptor.uniform_buffer_ptr)
+				{
+					buffer_infos[i].buffer = descriptor.uniform_buffer_ptr->Get();
+					buffer_infos[i].offset = descriptor.uniform_buffer_ptr->GetOffset() + descriptor.buffer_offset;
+					buffer_infos[i].range = descriptor.buffer_range;
+					writes[i] = kvfWriteUniformBufferToDescriptorSet(RenderCore::Get().GetDevice(), set, &buffer_infos[i], descriptor.binding);
+				}
+				else if(descriptor.storage_buffer_ptr)
+				{
+					buffer_infos[i].buffer = descriptor.storage_buffer_ptr->Get();
+					buffer_infos[i].offset = descriptor.storage_buffer_ptr->GetOffset() + descriptor.buffer_offset;
+					buffer_infos[i].range = descriptor.buffer_range;
+					writes[i] = kvfWriteStorageBufferToDescriptorSet(RenderCore::Get().GetDevice(), set, &buffer_infos[i], descriptor.binding);
+				}
+			}
+			RenderCore::Get().vkUpdateDescriptorSets(RenderCore::Get().GetDevice(), descriptors.size(), writes.data(), 0, nullptr);
+		}
+	}
+
 	void DescriptorPool::Init() noexcept
 	{
 		VkDescriptorPoolSize pool_sizes[] = {
@@ -47,10 +165,6 @@ namespace Scop
 	{
 		if(m_pool == VK_NULL_HANDLE)
 			return;
-		for(auto& set : m_free_sets)
-			kvfDestroyDescriptorSetLayout(RenderCore::Get().GetDevice(), set->m_set_layout);
-		for(auto& set : m_used_sets)
-			kvfDestroyDescriptorSetLayout(RenderCore::Get().GetDevice(), set->m_set_layout);
 		RenderCore::Get().vkDestroyDescriptorPool(RenderCore::Get().GetDevice(), m_pool, nullptr);
 		m_pool = VK_NULL_HANDLE;
 		m_allocation_count = 0;
@@ -60,43 +174,29 @@ namespace Scop
 
 	std::shared_ptr<DescriptorSet> DescriptorPool::RequestDescriptorSet(const ShaderSetLayout& layout, ShaderType shader_type)
 	{
-		auto it = std::find_if(m_free_sets.begin(), m_free_sets.end(), [&](std::shared_ptr<DescriptorSet> set)
-		{
-			return shader_type == set->GetShaderType() && layout == set->GetShaderLayout();
-		});
-		if(it != m_free_sets.end())
+		VkShaderStageFlagBits vulkan_shader_stage = Internal::ShaderTypeToVulkanStage(shader_type);
+		std::size_t hash = HashShaderSetLayout(layout, vulkan_shader_stage);
+		if(auto free_it = m_free_sets.find(hash); free_it != m_free_sets.end())
 		{
-			std::shared_ptr<DescriptorSet> set = *it;
-			m_free_sets.erase(it);
-			m_used_sets.push_back(set);
-			return set;
+			// Hash collisions are unlikely, the back of the list almost always matches
+			auto& free_sets = free_it->second;
+			for(auto it = free_sets.rbegin(); it != free_sets.rend(); ++it)
+			{
+				if((*it)->GetShaderType() != shader_type || !((*it)->GetShaderLayout() == layout))
+					continue;
+				std::shared_ptr<DescriptorSet> set = std::move(*it);
+				if(it != free_sets.rbegin())
+					*it = std::move(free_sets.back());
+				free_sets.pop_back();
+				set->m_pool_index = m_used_sets.size();
+				m_used_sets.push_back(set);
+				return set;
+			}
 		}
 
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> vulkan_sets;
 
-		VkShaderStageFlagBits vulkan_shader_stage;
-		switch(shader_type)
-		{
-			case ShaderType::Vertex: vulkan_shader_stage = VK_SHADER_STAGE_VERTEX_BIT; break;
-			case ShaderType::Fragment: vulkan_shader_stage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
-
-			default: FatalError("wtf"); vulkan_shader_stage = VK_SHADER_STAGE_VERTEX_BIT; /* Just to shut up warnings */ break;
-		}
-
-		std::vector<VkDescriptorSetLayoutBinding> bindings(layout.binds.size());
-		{
-			std::size_t i = 0;
-			for(auto& [bind, type] : layout.binds)
-			{
-				bindings[i].binding = bind;
-				bindings[i].descriptorCount = 1;
-				bindings[i].descriptorType = type;
-				bindings[i].pImmutableSamplers = nullptr;
-				bindings[i].stageFlags = vulkan_shader_stage;
-				i++;
-			}
-		}
-		VkDescriptorSetLayout vulkan_layout = kvfCreateDescriptorSetLayout(RenderCore::Get().GetDevice(), bindings.data(), bindings.size());
+		VkDescriptorSetLayout vulkan_layout = RenderCore::Get().GetDescriptorSetLayoutCache().Get(layout, vulkan_shader_stage);
 
 		for(int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 		{
@@ -111,179 +211,192 @@ namespace Scop
 			vulkan_sets[i] = vulkan_set;
 		}
 
-		std::shared_ptr<DescriptorSet> set(new DescriptorSet(*this, vulkan_layout, layout, std::move(vulkan_sets), shader_type));
+		std::shared_ptr<DescriptorSet> set(new DescriptorSet(*this, vulkan_layout, layout, hash, std::move(vulkan_sets), shader_type));
+		set->m_pool_index = m_used_sets.size();
 		m_used_sets.push_back(set);
 		return set;
 	}
 
 	void DescriptorPool::ReturnDescriptorSet(std::shared_ptr<DescriptorSet> set)
 	{
-		//std::size_t i = 0;
-		auto it = std::find_if(m_used_sets.begin(), m_used_sets.end(), [&](const std::shared_ptr<DescriptorSet>& rhs_set)
-		{
-			//i++;
-			//std::cout << m_used_sets.size() << " " << i << std::endl;
-			return set == rhs_set;
-		});
-		if(it == m_used_sets.end())
+		std::size_t index = set->m_pool_index;
+		if(index >= m_used_sets.size() || m_used_sets[index] != set)
 			return;
-		m_used_sets.erase(it);
-		m_free_sets.push_back(set);
+		if(index != m_used_sets.size() - 1)
+		{
+			m_used_sets[index] = std::move(m_used_sets.back());
+			m_used_sets[index]->m_pool_index = index;
+		}
+		m_used_sets.pop_back();
+		m_free_sets[set->m_layout_hash].push_back(std::move(set));
 	}
 
 	DescriptorPool& DescriptorPoolManager::GetAvailablePool()
 	{
 		for(auto& pool : m_pools)
 		{
-			if(pool.GetNumberOfSetsAllocated() < MAX_SETS_PER_POOL)
-				return pool;
+			if(pool->GetNumberOfSetsAllocated() < MAX_SETS_PER_POOL)
+				return *pool;
 		}
-		m_pools.emplace_back().Init();
-		return m_pools.back();
+		m_pools.emplace_back(std::make_unique<DescriptorPool>())->Init();
+		return *m_pools.back();
 	}
 
 	void DescriptorPoolManager::Destroy()
 	{
 		for(auto& pool : m_pools)
-			pool.Destroy();
+			pool->Destroy();
 		m_pools.clear();
 	}
 
-	DescriptorSet::DescriptorSet(DescriptorPool& pool, VkDescriptorSetLayout vulkan_layout, const ShaderSetLayout& layout, std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> vulkan_sets, ShaderType shader_type) :
+	VkDescriptorPool TransientDescriptorAllocator::CreatePool() const noexcept
+	{
+		VkDescriptorPoolSize pool_sizes[] = {
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TRANSIENT_SETS_PER_POOL },
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_TRANSIENT_SETS_PER_POOL },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_TRANSIENT_SETS_PER_POOL }
+		};
+
+		VkDescriptorPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
+		pool_info.pPoolSizes = pool_sizes;
+		pool_info.maxSets = MAX_TRANSIENT_SETS_PER_POOL;
+		pool_info.flags = 0;
+		VkDescriptorPool pool;
+		kvfCheckVk(RenderCore::Get().vkCreateDescriptorPool(RenderCore::Get().GetDevice(), &pool_info, nullptr, &pool));
+		return pool;
+	}
+
+	VkDescriptorSet TransientDescriptorAllocator::Allocate(std::size_t frame_index, VkDescriptorSetLayout layout)
+	{
+		auto& pools = m_pools[frame_index];
+		std::size_t& current = m_current_pools[frame_index];
+		for(;; current++)
+		{
+			if(current == pools.size())
+				pools.push_back(CreatePool());
+
+			VkDescriptorSetAllocateInfo alloc_info = {};
+			alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			alloc_info.descriptorPool = pools[current];
+			alloc_info.descriptorSetCount = 1;
+			alloc_info.pSetLayouts = &layout;
+			VkDescriptorSet set;
+			VkResult result = RenderCore::Get().vkAllocateDescriptorSets(RenderCore::Get().GetDevice(), &alloc_info, &set);
+			if(result == VK_SUCCESS)
+				return set;
+			if(result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+				kvfCheckVk(result);
+		}
+	}
+
+	void TransientDescriptorAllocator::Reset(std::size_t frame_index) noexcept
+	{
+		for(std::size_t i = 0; i < m_pools[frame_index].size() && i <= m_current_pools[frame_index]; i++)
+			RenderCore::Get().vkResetDescriptorPool(RenderCore::Get().GetDevice(), m_pools[frame_index][i], 0);
+		m_current_pools[frame_index] = 0;
+		m_epochs[frame_index]++;
+	}
+
+	void TransientDescriptorAllocator::Destroy() noexcept
+	{
+		for(std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			for(VkDescriptorPool pool : m_pools[i])
+				RenderCore::Get().vkDestroyDescriptorPool(RenderCore::Get().GetDevice(), pool, nullptr);
+			m_pools[i].clear();
+			m_current_pools[i] = 0;
+		}
+	}
+
+	void TransientDescriptorSet::Init(const ShaderSetLayout& layout, ShaderType shader_type)
+	{
+		m_set_layout = RenderCore::Get().GetDescriptorSetLayoutCache().Get(layout, Internal::ShaderTypeToVulkanStage(shader_type));
+		m_descriptors = Internal::MakeDescriptors(layout);
+		m_sets.fill(VK_NULL_HANDLE);
+		for(auto& written : m_written_descriptors)
+			written.clear();
+	}
+
+	void TransientDescriptorSet::SetImage(std::uint32_t binding, class Image& image)
+	{
+		if(Descriptor* descriptor = Internal::FindDescriptor(m_descriptors, binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER))
+			descriptor->image_ptr = &image;
+	}
+
+	void TransientDescriptorSet::SetStorageBuffer(std::uint32_t binding, class GPUBuffer& buffer, VkDeviceSize offset, VkDeviceSize range)
+	{
+		if(Descriptor* descriptor = Internal::FindDescriptor(m_descriptors, binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER))
+		{
+			descriptor->storage_buffer_ptr = &buffer;
+			descriptor->buffer_offset = offset;
+			descriptor->buffer_range = range;
+		}
+	}
+
+	void TransientDescriptorSet::SetUniformBuffer(std::uint32_t binding, class GPUBuffer& buffer)
+	{
+		if(Descriptor* descriptor = Internal::FindDescriptor(m_descriptors, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER))
+			descriptor->uniform_buffer_ptr = &buffer;
+	}
+
+	void TransientDescriptorSet::Update(std::size_t i, VkCommandBuffer cmd)
+	{
+		Verify(m_set_layout != VK_NULL_HANDLE, "invalid transient descriptor");
+		TransientDescriptorAllocator& allocator = RenderCore::Get().GetTransientDescriptorAllocator();
+		bool changed = Internal::PrepareDescriptors(m_descriptors, cmd, m_written_descriptors[i]);
+		// The set taken earlier in this frame is still alive until the next reset of the frame pools
+		if(m_sets[i] != VK_NULL_HANDLE && m_epochs[i] == allocator.GetEpoch(i) && !changed)
+			return;
+		m_sets[i] = allocator.Allocate(i, m_set_layout);
+		Internal::WriteDescriptors(m_sets[i], m_descriptors);
+		m_epochs[i] = allocator.GetEpoch(i);
+	}
+
+	DescriptorSet::DescriptorSet(DescriptorPool& pool, VkDescriptorSetLayout vulkan_layout, const ShaderSetLayout& layout, std::size_t layout_hash, std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> vulkan_sets, ShaderType shader_type) :
 		m_shader_layout(layout),
 		m_sets(std::move(vulkan_sets)),
 		m_set_layout(vulkan_layout),
+		m_layout_hash(layout_hash),
+		m_pool_index(0),
 		m_shader_type(shader_type),
 		m_pool(pool)
 	{
-		for(auto& [binding, type] : layout.binds)
-		{
-			m_descriptors.emplace_back();
-			m_descriptors.back().type = type;
-			m_descriptors.back().binding = binding;
-		}
+		m_descriptors = Internal::MakeDescriptors(layout);
 	}
 
 	void DescriptorSet::SetImage(std::size_t i, std::uint32_t binding, class Image& image)
 	{
 		Verify(m_sets[i] != VK_NULL_HANDLE, "invalid descriptor");
-		auto it = std::find_if(m_descriptors.begin(), m_descriptors.end(), [=](Descriptor descriptor)
-		{
-			return binding == descriptor.binding;
-		});
-		if(it == m_descriptors.end())
-		{
-			Warning("Vulkan: cannot update descriptor set image; invalid binding");
-			return;
-		}
-		if(it->type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
-		{
-			Error("Vulkan: trying to bind an image to the wrong descriptor");
-			return;
-		}
-		it->image_ptr = &image;
+		if(Descriptor* descriptor = Internal::FindDescriptor(m_descriptors, binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER))
+			descriptor->image_ptr = &image;
 	}
 
-	void DescriptorSet::SetStorageBuffer(std::size_t i, std::uint32_t binding, class GPUBuffer& buffer)
+	void DescriptorSet::SetStorageBuffer(std::size_t i, std::uint32_t binding, class GPUBuffer& buffer, VkDeviceSize offset, VkDeviceSize range)
 	{
 		Verify(m_sets[i] != VK_NULL_HANDLE, "invalid descriptor");
-		auto it = std::find_if(m_descriptors.begin(), m_descriptors.end(), [=](Descriptor descriptor)
-		{
-			return binding == descriptor.binding;
-		});
-		if(it == m_descriptors.end())
-		{
-			Warning("Vulkan: cannot update descriptor set buffer; invalid binding");
-			return;
-		}
-		if(it->type != VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+		if(Descriptor* descriptor = Internal::FindDescriptor(m_descriptors, binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER))
 		{
-			Error("Vulkan: trying to bind a buffer to the wrong descriptor");
-			return;
+			descriptor->storage_buffer_ptr = &buffer;
+			descriptor->buffer_offset = offset;
+			descriptor->buffer_range = range;
 		}
-		it->storage_buffer_ptr = &buffer;
 	}
 
 	void DescriptorSet::SetUniformBuffer(std::size_t i, std::uint32_t binding, class GPUBuffer& buffer)
 	{
 		Verify(m_sets[i] != VK_NULL_HANDLE, "invalid descriptor");
-		auto it = std::find_if(m_descriptors.begin(), m_descriptors.end(), [=](Descriptor descriptor)
-		{
-			return binding == descriptor.binding;
-		});
-		if(it == m_descriptors.end())
-		{
-			Warning("Vulkan: cannot update descriptor set buffer; invalid binding");
-			return;
-		}
-		if(it->type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
-		{
-			Error("Vulkan: trying to bind a buffer to the wrong descriptor");
-			return;
-		}
-		it->uniform_buffer_ptr = &buffer;
+		if(Descriptor* descriptor = Internal::FindDescriptor(m_descriptors, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER))
+			descriptor->uniform_buffer_ptr = &buffer;
 	}
 
 	void DescriptorSet::Update(std::size_t i, VkCommandBuffer cmd) noexcept
 	{
 		Verify(m_sets[i] != VK_NULL_HANDLE, "invalid descriptor");
-
-		std::size_t image_count = 0;
-		std::size_t buffer_count = 0;
-
-		for(auto& descriptor : m_descriptors)
-		{
-			if(descriptor.image_ptr)
-				image_count++;
-			else if(descriptor.uniform_buffer_ptr || descriptor.storage_buffer_ptr)
-				buffer_count++;
-			else
-				FatalError("unknown descriptor data");
-		}
-
-		std::vector<VkWriteDescriptorSet> writes(m_descriptors.size());
-		std::vector<VkDescriptorBufferInfo> buffer_infos(buffer_count);
-		std::vector<VkDescriptorImageInfo> image_infos(image_count);
-		std::size_t buffer_index = 0;
-		std::size_t image_index = 0;
-		std::size_t write_index = 0;
-
-		for(auto& descriptor : m_descriptors)
-		{
-			if(descriptor.image_ptr)
-			{
-				TransitionImageToCorrectLayout(*descriptor.image_ptr, cmd);
-				VkDescriptorImageInfo info{};
-				info.sampler = descriptor.image_ptr->GetSampler();
-				info.imageLayout = descriptor.image_ptr->GetLayout();
-				info.imageView = descriptor.image_ptr->GetImageView();
-				image_infos[image_index] = std::move(info);
-				writes[write_index] = kvfWriteImageToDescriptorSet(RenderCore::Get().GetDevice(), m_sets[i], &image_infos[image_index], descriptor.binding);
-				image_index++;
-			}
-			else if(descriptor.uniform_buffer_ptr)
-			{
-				VkDescriptorBufferInfo info{};
-				info.buffer = descriptor.uniform_buffer_ptr->Get();
-				info.offset = descriptor.uniform_buffer_ptr->GetOffset();
-				info.range = VK_WHOLE_SIZE;
-				buffer_infos[buffer_index] = std::move(info);
-				writes[write_index] = kvfWriteUniformBufferToDescriptorSet(RenderCore::Get().GetDevice(), m_sets[i], &buffer_infos[buffer_index], descriptor.binding);
-				buffer_index++;
-			}
-			else if(descriptor.storage_buffer_ptr)
-			{
-				VkDescriptorBufferInfo info{};
-				info.buffer = descriptor.storage_buffer_ptr->Get();
-				info.offset = descriptor.storage_buffer_ptr->GetOffset();
-				info.range = VK_WHOLE_SIZE;
-				buffer_infos[buffer_index] = std::move(info);
-				writes[write_index] = kvfWriteStorageBufferToDescriptorSet(RenderCore::Get().GetDevice(), m_sets[i], &buffer_infos[buffer_index], descriptor.binding);
-				buffer_index++;
-			}
-			write_index++;
-		}
-		RenderCore::Get().vkUpdateDescriptorSets(RenderCore::Get().GetDevice(), writes.size(), writes.data(), 0, nullptr);
+		if(!Internal::PrepareDescriptors(m_descriptors, cmd, m_written_descriptors[i]))
+			return;
+		Internal::WriteDescriptors(m_sets[i], m_descriptors);
 	}
 
 	void DescriptorSet::ReturnDescriptorSetToPool()
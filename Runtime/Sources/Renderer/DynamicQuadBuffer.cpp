@@ -0,0 +1,136 @@
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+#include <Renderer/DynamicQuadBuffer.h>
+#include <Renderer/RenderCore.h>
+#include <Core/Logs.h>
+
+namespace Scop
+{
+	static_assert(MAX_FRAMES_IN_FLIGHT <= 8, "quad dirty masks are stored on 8 bits");
+
+	constexpr std::uint8_t ALL_QUAD_FRAMES_DIRTY = static_cast<std::uint8_t>((1u << MAX_FRAMES_IN_FLIGHT) - 1);
+
+	namespace Internal
+	{
+		// Trailing padding of vertices is left out of the comparison
+		bool IsSameQuad(const Quad& lhs, const Quad& rhs) noexcept
+		{
+			constexpr std::size_t vertex_data_size = offsetof(Vertex, uv) + sizeof(Vec2f);
+			for(std::size_t i = 0; i < lhs.size(); i++)
+			{
+				if(std::memcmp(&lhs[i], &rhs[i], vertex_data_size) != 0)
+					return false;
+			}
+			return true;
+		}
+	}
+
+	void DynamicQuadBuffer::Init(std::uint32_t capacity, std::string_view name)
+	{
+		m_name = name;
+		m_capacity = std::max(capacity, 1u);
+		m_count = 0;
+		m_shadow.resize(m_capacity);
+		m_dirty_frames.assign(m_capacity, ALL_QUAD_FRAMES_DIRTY); // Mapped regions start uninitialised
+		CreateBuffers();
+	}
+
+	void DynamicQuadBuffer::CreateBuffers()
+	{
+		m_vertex_buffer.Init(BufferType::HighDynamic, MAX_FRAMES_IN_FLIGHT * m_capacity * sizeof(Quad), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, {}, m_name);
+		if(m_vertex_buffer.GetMap() == nullptr)
+			FatalError("Vulkan: unable to map a dynamic quad buffer");
+
+		CPUBuffer indices(m_capacity * 6 * sizeof(std::uint32_t));
+		std::uint32_t* data = indices.GetDataAs<std::uint32_t>();
+		for(std::uint32_t i = 0; i < m_capacity; i++)
+		{
+			data[i * 6 + 0] = i * 4 + 0;
+			data[i * 6 + 1] = i * 4 + 1;
+			data[i * 6 + 2] = i * 4 + 2;
+			data[i * 6 + 3] = i * 4 + 2;
+			data[i * 6 + 4] = i * 4 + 3;
+			data[i * 6 + 5] = i * 4 + 0;
+		}
+		m_index_buffer.Init(BufferType::LowDynamic, indices.GetSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, std::move(indices), m_name);
+	}
+
+	void DynamicQuadBuffer::Resize(std::uint32_t count)
+	{
+		if(count > m_capacity)
+		{
+			m_capacity = std::max(count, m_capacity * 2);
+			m_shadow.resize(m_capacity);
+			// Frame regions moved, every quad has to be copied again
+			m_dirty_frames.assign(m_capacity, ALL_QUAD_FRAMES_DIRTY);
+			m_vertex_buffer.Destroy();
+			m_index_buffer.Destroy();
+			CreateBuffers();
+		}
+		m_count = count;
+	}
+
+	void DynamicQuadBuffer::SetQuad(std::uint32_t index, const Quad& quad) noexcept
+	{
+		if(index >= m_count)
+			return;
+		if(Internal::IsSameQuad(m_shadow[index], quad))
+			return;
+		m_shadow[index] = quad;
+		m_dirty_frames[index] = ALL_QUAD_FRAMES_DIRTY;
+	}
+
+	void DynamicQuadBuffer::Flush(std::size_t frame_index) noexcept
+	{
+		std::uint8_t bit = static_cast<std::uint8_t>(1u << frame_index);
+		Quad* region = static_cast<Quad*>(m_vertex_buffer.GetMap()) + frame_index * m_capacity;
+		// Copies runs of consecutive dirty quads at once
+		for(std::uint32_t i = 0; i < m_count;)
+		{
+			if(!(m_dirty_frames[i] & bit))
+			{
+				i++;
+				continue;
+			}
+			std::uint32_t first = i;
+			for(; i < m_count && (m_dirty_frames[i] & bit); i++)
+				m_dirty_frames[i] &= ~bit;
+			std::memcpy(region + first, m_shadow.data() + first, (i - first) * sizeof(Quad));
+		}
+	}
+
+	void DynamicQuadBuffer::Bind(VkCommandBuffer cmd, std::size_t frame_index) const noexcept
+	{
+		VkBuffer buffer = m_vertex_buffer.Get();
+		VkDeviceSize offset = frame_index * m_capacity * sizeof(Quad);
+		RenderCore::Get().vkCmdBindVertexBuffers(cmd, 0, 1, &buffer, &offset);
+		RenderCore::Get().vkCmdBindIndexBuffer(cmd, m_index_buffer.Get(), 0, VK_INDEX_TYPE_UINT32);
+	}
+
+	void DynamicQuadBuffer::Draw(VkCommandBuffer cmd, std::uint32_t first_quad, std::uint32_t quad_count, std::size_t& drawcalls, std::size_t& polygondrawn) const noexcept
+	{
+		if(quad_count == 0)
+			return;
+		RenderCore::Get().vkCmdDrawIndexed(cmd, quad_count * 6, 1, first_quad * 6, 0, 0);
+		polygondrawn += quad_count * 2;
+		drawcalls++;
+	}
+
+	void DynamicQuadBuffer::Destroy() noexcept
+	{
+		m_vertex_buffer.Destroy();
+		m_index_buffer.Destroy();
+		m_shadow.clear();
+		m_dirty_frames.clear();
+		m_capacity = 0;
+		m_count = 0;
+	}
+
+	DynamicQuadBuffer::~DynamicQuadBuffer()
+	{
+		if(RenderCore::IsInit())
+			Destroy();
+	}
+}
@@ -1,10 +1,67 @@
+#include <cstring>
+
 #include <Renderer/Image.h>
 #include <Renderer/RenderCore.h>
+#include <Renderer/TextureStreamer.h>
 #include <Core/Logs.h>
 
 namespace Scop
 {
-	void Image::Init(ImageType type, std::uint32_t width, std::uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, bool is_multisampled, std::string_view name, bool dedicated_alloc)
+	namespace Internal
+	{
+		void RecordMipsBarrier(VkCommandBuffer cmd, VkImage image, VkImageLayout old_layout, VkImageLayout new_layout, std::uint32_t base_mip, std::uint32_t mip_count, std::uint32_t layer_count)
+		{
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = old_layout;
+			barrier.newLayout = new_layout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.baseMipLevel = base_mip;
+			barrier.subresourceRange.levelCount = mip_count;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = layer_count;
+			barrier.srcAccessMask = kvfLayoutToAccessMask(old_layout, false);
+			barrier.dstAccessMask = kvfLayoutToAccessMask(new_layout, true);
+
+			constexpr VkPipelineStageFlags shader_stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			VkPipelineStageFlags source_stage = (barrier.srcAccessMask != 0 ? kvfAccessFlagsToPipelineStage(barrier.srcAccessMask, shader_stages) : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+			VkPipelineStageFlags destination_stage = (barrier.dstAccessMask != 0 ? kvfAccessFlagsToPipelineStage(barrier.dstAccessMask, shader_stages) : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+			RenderCore::Get().vkCmdPipelineBarrier(cmd, source_stage, destination_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+
+		bool IsEightBitsFourChannelsFormat(VkFormat format) noexcept
+		{
+			switch(format)
+			{
+				case VK_FORMAT_R8G8B8A8_UNORM:
+				case VK_FORMAT_R8G8B8A8_SRGB:
+				case VK_FORMAT_B8G8R8A8_UNORM:
+				case VK_FORMAT_B8G8R8A8_SRGB: return true;
+
+				default: return false;
+			}
+		}
+
+		bool SupportsSampling(VkFormat format)
+		{
+			VkFormatProperties properties;
+			RenderCore::Get().vkGetPhysicalDeviceFormatProperties(RenderCore::Get().GetPhysicalDevice(), format, &properties);
+			return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+		}
+
+		bool SupportsLinearBlit(VkFormat format)
+		{
+			VkFormatProperties properties;
+			RenderCore::Get().vkGetPhysicalDeviceFormatProperties(RenderCore::Get().GetPhysicalDevice(), format, &properties);
+			constexpr VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+			return (properties.optimalTilingFeatures & needed) == needed;
+		}
+	}
+
+	void Image::Init(ImageType type, std::uint32_t width, std::uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, bool is_multisampled, std::string_view name, bool dedicated_alloc, std::uint32_t mip_levels)
 	{
 		m_type = type;
 		m_width = width;
@@ -12,6 +69,7 @@ namespace Scop
 		m_format = format;
 		m_tiling = tiling;
 		m_is_multisampled = is_multisampled;
+		m_mip_levels = (is_multisampled ? 1 : std::max(mip_levels, 1u));
 
 		KvfImageType kvf_type = KVF_IMAGE_OTHER;
 		switch(m_type)
@@ -23,21 +81,22 @@ namespace Scop
 			default: break;
 		}
 
-		if(m_is_multisampled)
+		if(m_is_multisampled || m_mip_levels > 1)
 		{
 			VkImageCreateInfo image_info{};
 			image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			image_info.flags = (m_type == ImageType::Cube ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0);
 			image_info.imageType = VK_IMAGE_TYPE_2D;
 			image_info.extent.width = width;
 			image_info.extent.height = height;
 			image_info.extent.depth = 1;
-			image_info.mipLevels = 1;
+			image_info.mipLevels = m_mip_levels;
 			image_info.arrayLayers = (m_type == ImageType::Cube ? 6 : 1);
 			image_info.format = format;
 			image_info.tiling = tiling;
 			image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 			image_info.usage = usage;
-			image_info.samples = VK_SAMPLE_COUNT_4_BIT;
+			image_info.samples = (m_is_multisampled ? VK_SAMPLE_COUNT_4_BIT : VK_SAMPLE_COUNT_1_BIT);
 			image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			kvfCheckVk(RenderCore::Get().vkCreateImage(RenderCore::Get().GetDevice(), &image_info, nullptr, &m_image));
 		}
@@ -59,17 +118,47 @@ namespace Scop
 			RenderCore::Get().vkSetDebugUtilsObjectNameEXT(RenderCore::Get().GetDevice(), &name_info);
 		#endif
 
+		m_generation = s_next_generation++;
 		s_image_count++;
 	}
 
-	void Image::CreateImageView(VkImageViewType type, VkImageAspectFlags aspect_flags, int layer_count) noexcept
+	VkComponentMapping GetTextureComponentMapping(VkFormat format) noexcept
 	{
-		m_image_view = kvfCreateImageView(RenderCore::Get().GetDevice(), m_image, m_format, type, aspect_flags, layer_count);
+		switch(format)
+		{
+			case VK_FORMAT_R8_UNORM:
+			case VK_FORMAT_R8_SRGB:
+			case VK_FORMAT_BC4_UNORM_BLOCK: return { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R };
+
+			default: return {};
+		}
+	}
+
+	void Image::CreateImageView(VkImageViewType type, VkImageAspectFlags aspect_flags, int layer_count, VkComponentMapping components) noexcept
+	{
+		bool is_identity = (components.r == VK_COMPONENT_SWIZZLE_IDENTITY && components.g == VK_COMPONENT_SWIZZLE_IDENTITY && components.b == VK_COMPONENT_SWIZZLE_IDENTITY && components.a == VK_COMPONENT_SWIZZLE_IDENTITY);
+		if(m_mip_levels == 1 && is_identity)
+		{
+			m_image_view = kvfCreateImageView(RenderCore::Get().GetDevice(), m_image, m_format, type, aspect_flags, layer_count);
+			return;
+		}
+		VkImageViewCreateInfo create_info{};
+		create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		create_info.image = m_image;
+		create_info.viewType = type;
+		create_info.format = m_format;
+		create_info.components = components;
+		create_info.subresourceRange.aspectMask = aspect_flags;
+		create_info.subresourceRange.baseMipLevel = 0;
+		create_info.subresourceRange.levelCount = m_mip_levels;
+		create_info.subresourceRange.baseArrayLayer = 0;
+		create_info.subresourceRange.layerCount = layer_count;
+		kvfCheckVk(RenderCore::Get().vkCreateImageView(RenderCore::Get().GetDevice(), &create_info, nullptr, &m_image_view));
 	}
 
 	void Image::CreateSampler() noexcept
 	{
-		m_sampler = kvfCreateSampler(RenderCore::Get().GetDevice(), VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_MIPMAP_MODE_NEAREST);
+		m_sampler = kvfCreateSampler(RenderCore::Get().GetDevice(), VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT, m_mip_levels > 1 ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST);
 	}
 
 	void Image::TransitionLayout(VkImageLayout new_layout, VkCommandBuffer cmd)
@@ -77,6 +166,27 @@ namespace Scop
 		if(new_layout == m_layout)
 			return;
 		bool is_single_time_cmd_buffer = (cmd == VK_NULL_HANDLE);
+		if(m_mip_levels > 1)
+		{
+			// KVF transitions only the first mip
+			VkDevice device = RenderCore::Get().GetDevice();
+			if(is_single_time_cmd_buffer)
+			{
+				cmd = kvfCreateCommandBuffer(device);
+				kvfBeginCommandBuffer(cmd, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+			}
+			Internal::RecordMipsBarrier(cmd, m_image, m_layout, new_layout, 0, m_mip_levels, m_type == ImageType::Cube ? 6 : 1);
+			if(is_single_time_cmd_buffer)
+			{
+				kvfEndCommandBuffer(cmd);
+				VkFence fence = kvfCreateFence(device);
+				kvfSubmitSingleTimeCommandBuffer(device, cmd, KVF_GRAPHICS_QUEUE, fence);
+				kvfDestroyFence(device, fence);
+				kvfDestroyCommandBuffer(device, cmd);
+			}
+			m_layout = new_layout;
+			return;
+		}
 		KvfImageType kvf_type = KVF_IMAGE_OTHER;
 		switch(m_type)
 		{
@@ -120,6 +230,137 @@ namespace Scop
 		}
 	}
 
+	void Image::UploadMipLevels(const std::vector<CPUBuffer>& levels, std::uint32_t first_level)
+	{
+		Verify(levels.size() >= first_level + m_mip_levels, "not enough mip levels to upload");
+
+		std::size_t size = 0;
+		for(std::uint32_t i = 0; i < m_mip_levels; i++)
+			size += levels[first_level + i].GetSize();
+		CPUBuffer complete_data(size);
+
+		std::vector<std::size_t> mip_offsets(m_mip_levels);
+		std::size_t offset = 0;
+		for(std::uint32_t i = 0; i < m_mip_levels; i++)
+		{
+			const CPUBuffer& level = levels[first_level + i];
+			std::memcpy(complete_data.GetData() + offset, level.GetData(), level.GetSize());
+			mip_offsets[i] = offset;
+			offset += level.GetSize();
+		}
+		UploadMipLevels(complete_data, mip_offsets);
+	}
+
+	void Image::UploadMipLevels(const CPUBuffer& data, const std::vector<std::size_t>& mip_offsets)
+	{
+		Verify(mip_offsets.size() >= m_mip_levels, "not enough mip levels to upload");
+
+		std::vector<VkBufferImageCopy> buffer_copy_regions(m_mip_levels);
+		for(std::uint32_t i = 0; i < m_mip_levels; i++)
+		{
+			VkBufferImageCopy& region = buffer_copy_regions[i];
+			region = {};
+			region.bufferOffset = mip_offsets[i];
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = i;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageExtent.width = std::max(m_width >> i, 1u);
+			region.imageExtent.height = std::max(m_height >> i, 1u);
+			region.imageExtent.depth = 1;
+		}
+
+		GPUBuffer staging_buffer;
+		staging_buffer.Init(BufferType::Staging, data.GetSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, data);
+
+		VkDevice device = RenderCore::Get().GetDevice();
+		VkCommandBuffer cmd = kvfCreateCommandBuffer(device);
+		kvfBeginCommandBuffer(cmd, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd);
+		RenderCore::Get().vkCmdCopyBufferToImage(cmd, staging_buffer.Get(), m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, buffer_copy_regions.size(), buffer_copy_regions.data());
+		TransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cmd);
+		kvfEndCommandBuffer(cmd);
+
+		VkFence fence = kvfCreateFence(device);
+		kvfSubmitSingleTimeCommandBuffer(device, cmd, KVF_GRAPHICS_QUEUE, fence);
+		kvfDestroyFence(device, fence);
+		kvfDestroyCommandBuffer(device, cmd);
+		staging_buffer.Destroy();
+	}
+
+	void Image::UploadRegion(const CPUBuffer& pixels, std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height)
+	{
+		VkBufferImageCopy region{};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { static_cast<std::int32_t>(x), static_cast<std::int32_t>(y), 0 };
+		region.imageExtent = { width, height, 1 };
+
+		GPUBuffer staging_buffer;
+		staging_buffer.Init(BufferType::Staging, pixels.GetSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, pixels);
+
+		VkDevice device = RenderCore::Get().GetDevice();
+		VkCommandBuffer cmd = kvfCreateCommandBuffer(device);
+		kvfBeginCommandBuffer(cmd, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd);
+		RenderCore::Get().vkCmdCopyBufferToImage(cmd, staging_buffer.Get(), m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+		TransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cmd);
+		kvfEndCommandBuffer(cmd);
+
+		VkFence fence = kvfCreateFence(device);
+		kvfSubmitSingleTimeCommandBuffer(device, cmd, KVF_GRAPHICS_QUEUE, fence);
+		kvfDestroyFence(device, fence);
+		kvfDestroyCommandBuffer(device, cmd);
+		staging_buffer.Destroy();
+	}
+
+	void Image::GenerateMipmaps(VkCommandBuffer cmd)
+	{
+		std::int32_t mip_width = static_cast<std::int32_t>(m_width);
+		std::int32_t mip_height = static_cast<std::int32_t>(m_height);
+		for(std::uint32_t i = 1; i < m_mip_levels; i++)
+		{
+			Internal::RecordMipsBarrier(cmd, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, i - 1, 1, 1);
+
+			VkImageBlit blit{};
+			blit.srcOffsets[1] = { mip_width, mip_height, 1 };
+			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.srcSubresource.mipLevel = i - 1;
+			blit.srcSubresource.baseArrayLayer = 0;
+			blit.srcSubresource.layerCount = 1;
+			mip_width = std::max(mip_width / 2, 1);
+			mip_height = std::max(mip_height / 2, 1);
+			blit.dstOffsets[1] = { mip_width, mip_height, 1 };
+			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.dstSubresource.mipLevel = i;
+			blit.dstSubresource.baseArrayLayer = 0;
+			blit.dstSubresource.layerCount = 1;
+			RenderCore::Get().vkCmdBlitImage(cmd, m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+			Internal::RecordMipsBarrier(cmd, m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, i - 1, 1, 1);
+		}
+		Internal::RecordMipsBarrier(cmd, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_mip_levels - 1, 1, 1);
+		m_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+
+	void Image::SwapStorage(Image& image) noexcept
+	{
+		m_memory.Swap(image.m_memory);
+		std::swap(m_image, image.m_image);
+		std::swap(m_image_view, image.m_image_view);
+		std::swap(m_sampler, image.m_sampler);
+		std::swap(m_format, image.m_format);
+		std::swap(m_tiling, image.m_tiling);
+		std::swap(m_layout, image.m_layout);
+		std::swap(m_type, image.m_type);
+		std::swap(m_mip_levels, image.m_mip_levels);
+		std::swap(m_is_multisampled, image.m_is_multisampled);
+		m_generation = s_next_generation++;
+		image.m_generation = s_next_generation++;
+	}
+
 	void Image::DestroySampler() noexcept
 	{
 		if(m_sampler != VK_NULL_HANDLE)
@@ -134,11 +375,161 @@ namespace Scop
 		m_image_view = VK_NULL_HANDLE;
 	}
 
+	void Texture::Init(CPUBuffer pixels, std::uint32_t width, std::uint32_t height, VkFormat format, bool is_multisampled, std::string_view name, bool dedicated_alloc, TextureMipmapMode mipmaps)
+	{
+		if(pixels && IsBlockCompressedFormat(format))
+		{
+			// Compressed pixels cannot be filtered nor blitted, a chain has to be precompiled
+			if(mipmaps != TextureMipmapMode::None)
+				Warning("Vulkan: cannot generate mipmaps for a block compressed texture, use a precompiled mip chain");
+			InitFromMipChain(std::move(pixels), { 0 }, width, height, format, std::move(name));
+			return;
+		}
+		if(!pixels || is_multisampled)
+			mipmaps = TextureMipmapMode::None;
+		bool can_filter_on_cpu = Internal::IsEightBitsFourChannelsFormat(format);
+		bool can_blit = (mipmaps != TextureMipmapMode::None && Internal::SupportsLinearBlit(format));
+
+		if(mipmaps == TextureMipmapMode::Stream)
+		{
+			if(can_filter_on_cpu)
+			{
+				m_is_streamed = true;
+				SetExtent(width, height);
+				RenderCore::Get().GetTextureStreamer().Register(*this, GenerateMipChain(pixels, width, height), format);
+				RegisterBindless();
+				return;
+			}
+			Warning("Vulkan: texture streaming needs an 8 bits RGBA format, generating the whole mip chain instead");
+			mipmaps = TextureMipmapMode::Generate;
+		}
+		if(mipmaps == TextureMipmapMode::Generate && !can_blit && !can_filter_on_cpu)
+		{
+			Warning("Vulkan: cannot generate mipmaps for this texture format");
+			mipmaps = TextureMipmapMode::None;
+		}
+
+		std::uint32_t mip_levels = (mipmaps == TextureMipmapMode::Generate ? ComputeMipLevelsCount(width, height) : 1);
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		if(mip_levels > 1)
+			usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		Image::Init(ImageType::Color, width, height, format, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, is_multisampled, std::move(name), dedicated_alloc, mip_levels);
+		// Render targets views must keep the identity mapping to be used as attachments
+		Image::CreateImageView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, 1, pixels ? GetTextureComponentMapping(format) : VkComponentMapping{});
+		Image::CreateSampler();
+		if(!pixels)
+		{
+			TransitionLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+			return;
+		}
+		if(mip_levels > 1 && !can_blit)
+			UploadMipLevels(GenerateMipChain(pixels, width, height));
+		else
+			UploadPixels(std::move(pixels), mip_levels > 1);
+		RegisterBindless();
+	}
+
+	bool Texture::InitFromMipChain(CPUBuffer data, const std::vector<std::size_t>& mip_offsets, std::uint32_t width, std::uint32_t height, VkFormat format, std::string_view name, bool streamed)
+	{
+		if(!data || mip_offsets.empty())
+			FatalError("Vulkan: a texture cannot be created from an empty mip chain");
+		if(IsBlockCompressedFormat(format) && !Internal::SupportsSampling(format))
+		{
+			Error("Vulkan: block compressed format is not supported by the physical device");
+			return false;
+		}
+
+		if(streamed && mip_offsets.size() > 1)
+		{
+			std::vector<CPUBuffer> mips(mip_offsets.size());
+			for(std::size_t i = 0; i < mips.size(); i++)
+			{
+				std::size_t size = (i + 1 < mip_offsets.size() ? mip_offsets[i + 1] : data.GetSize()) - mip_offsets[i]; // May include the container padding
+				if(IsBlockCompressedFormat(format))
+					size = ComputeCompressedLevelSize(format, std::max(width >> i, 1u), std::max(height >> i, 1u));
+				mips[i].Allocate(size);
+				std::memcpy(mips[i].GetData(), data.GetData() + mip_offsets[i], size);
+			}
+			m_is_streamed = true;
+			SetExtent(width, height);
+			RenderCore::Get().GetTextureStreamer().Register(*this, std::move(mips), format);
+			RegisterBindless();
+			return true;
+		}
+
+		Image::Init(ImageType::Color, width, height, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, std::move(name), false, static_cast<std::uint32_t>(mip_offsets.size()));
+		Image::CreateImageView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, 1, GetTextureComponentMapping(format));
+		Image::CreateSampler();
+		UploadMipLevels(data, mip_offsets);
+		RegisterBindless();
+		return true;
+	}
+
+	void Texture::UploadPixels(CPUBuffer pixels, bool generate_mipmaps)
+	{
+		TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		GPUBuffer staging_buffer;
+		std::size_t size = GetWidth() * GetHeight() * kvfFormatSize(GetFormat());
+		staging_buffer.Init(BufferType::Staging, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, pixels);
+		VkCommandBuffer cmd = kvfCreateCommandBuffer(RenderCore::Get().GetDevice());
+		kvfBeginCommandBuffer(cmd, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		kvfCopyBufferToImage(cmd, Image::Get(), staging_buffer.Get(), staging_buffer.GetOffset(), VK_IMAGE_ASPECT_COLOR_BIT, { GetWidth(), GetHeight(), 1 });
+		if(generate_mipmaps)
+			GenerateMipmaps(cmd);
+		RenderCore::Get().vkEndCommandBuffer(cmd);
+		VkFence fence = kvfCreateFence(RenderCore::Get().GetDevice());
+		kvfSubmitSingleTimeCommandBuffer(RenderCore::Get().GetDevice(), cmd, KVF_GRAPHICS_QUEUE, fence);
+		kvfDestroyFence(RenderCore::Get().GetDevice(), fence);
+		staging_buffer.Destroy();
+		TransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
+	void Texture::RegisterBindless()
+	{
+		if(RenderCore::Get().IsBindlessEnabled() && m_bindless_index == BINDLESS_INVALID_INDEX)
+			m_bindless_index = RenderCore::Get().GetBindlessTextureTable().Register(*this);
+	}
+
+	void Texture::RefreshBindless()
+	{
+		if(!RenderCore::Get().IsBindlessEnabled())
+			return;
+		// Streamed textures have no view to register until their first mips are resident.
+		// The old slot is retired, frames in flight keep sampling the previous view through it
+		std::uint32_t index = RenderCore::Get().GetBindlessTextureTable().Register(*this);
+		RenderCore::Get().GetBindlessTextureTable().Release(m_bindless_index);
+		m_bindless_index = index;
+	}
+
+	void Texture::MarkUsed() noexcept
+	{
+		if(m_is_streamed)
+			m_last_use_frame = RenderCore::Get().GetTextureStreamer().GetCurrentFrame();
+	}
+
+	void Texture::Destroy() noexcept
+	{
+		if(m_bindless_index != BINDLESS_INVALID_INDEX && RenderCore::IsInit() && RenderCore::Get().IsBindlessEnabled())
+			RenderCore::Get().GetBindlessTextureTable().Release(m_bindless_index);
+		m_bindless_index = BINDLESS_INVALID_INDEX;
+		if(m_is_streamed && RenderCore::IsInit())
+			RenderCore::Get().GetTextureStreamer().Unregister(*this);
+		m_is_streamed = false;
+		Image::Destroy();
+	}
+
 	void Image::Destroy() noexcept
 	{
 		if(m_image == VK_NULL_HANDLE && m_image_view == VK_NULL_HANDLE && m_sampler == VK_NULL_HANDLE)
 			return;
 		RenderCore::Get().WaitDeviceIdle();
+		DestroyWithoutSync();
+	}
+
+	void Image::DestroyWithoutSync() noexcept
+	{
+		if(m_image == VK_NULL_HANDLE && m_image_view == VK_NULL_HANDLE && m_sampler == VK_NULL_HANDLE)
+			return;
 		DestroySampler();
 		DestroyImageView();
 
@@ -156,7 +547,9 @@ namespace Scop
 		m_layout = VK_IMAGE_LAYOUT_UNDEFINED;
 		m_width = 0;
 		m_height = 0;
+		m_mip_levels = 1;
 		m_is_multisampled = false;
+		m_generation = 0;
 		s_image_count--;
 	}
 
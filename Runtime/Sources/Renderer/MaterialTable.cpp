@@ -0,0 +1,109 @@
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+
+#include <Renderer/MaterialTable.h>
+#include <Renderer/RenderCore.h>
+#include <Core/Logs.h>
+
+namespace Scop
+{
+	static_assert(MAX_FRAMES_IN_FLIGHT <= 8, "material table dirty masks are stored on 8 bits");
+
+	constexpr std::uint8_t ALL_FRAMES_DIRTY = static_cast<std::uint8_t>((1u << MAX_FRAMES_IN_FLIGHT) - 1);
+
+	void MaterialTable::Init(std::uint32_t slot_size, std::uint32_t capacity)
+	{
+		VkPhysicalDeviceProperties props;
+		RenderCore::Get().vkGetPhysicalDeviceProperties(RenderCore::Get().GetPhysicalDevice(), &props);
+		VkDeviceSize alignment = std::max<VkDeviceSize>(props.limits.minStorageBufferOffsetAlignment, 1);
+
+		m_slot_size = slot_size;
+		m_stride = (m_slot_size + alignment - 1) / alignment * alignment;
+		// Bindless shaders index the whole frame region with a slot_size array stride
+		if(m_stride % m_slot_size != 0)
+			m_stride = std::lcm(m_stride, m_slot_size);
+		m_capacity = capacity;
+		m_shadow.resize(m_capacity * m_stride);
+		m_dirty_frames.resize(m_capacity, 0);
+		CreateBuffer();
+		Message("Vulkan: material table created (% slots of % bytes)", m_capacity, m_stride);
+	}
+
+	void MaterialTable::CreateBuffer()
+	{
+		m_buffer.Init(BufferType::HighDynamic, MAX_FRAMES_IN_FLIGHT * m_capacity * m_stride, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, {}, "scop_material_table");
+		if(m_buffer.GetMap() == nullptr)
+			FatalError("Vulkan: unable to map the material table");
+	}
+
+	void MaterialTable::Grow()
+	{
+		m_capacity *= 2;
+		m_shadow.resize(m_capacity * m_stride);
+		m_dirty_frames.resize(m_capacity, 0);
+		// Frame regions moved, every live slot has to be copied again
+		std::fill(m_dirty_frames.begin(), m_dirty_frames.begin() + m_next_slot, ALL_FRAMES_DIRTY);
+		m_buffer.Destroy();
+		CreateBuffer();
+		Message("Vulkan: material table grown to % slots", m_capacity);
+	}
+
+	std::uint32_t MaterialTable::Register()
+	{
+		std::uint32_t slot;
+		if(!m_free_slots.empty())
+		{
+			slot = m_free_slots.back();
+			m_free_slots.pop_back();
+		}
+		else
+		{
+			if(m_next_slot == m_capacity)
+				Grow();
+			slot = m_next_slot++;
+		}
+		std::memset(m_shadow.data() + slot * m_stride, 0, m_stride);
+		m_dirty_frames[slot] = ALL_FRAMES_DIRTY;
+		return slot;
+	}
+
+	void MaterialTable::Release(std::uint32_t slot) noexcept
+	{
+		if(slot == MATERIAL_TABLE_INVALID_SLOT || slot >= m_next_slot)
+			return;
+		m_dirty_frames[slot] = 0;
+		m_free_slots.push_back(slot);
+	}
+
+	void MaterialTable::SetData(std::uint32_t slot, const void* data) noexcept
+	{
+		if(slot >= m_next_slot)
+			return;
+		std::uint8_t* dst = m_shadow.data() + slot * m_stride;
+		if(std::memcmp(dst, data, m_slot_size) == 0)
+			return;
+		std::memcpy(dst, data, m_slot_size);
+		m_dirty_frames[slot] = ALL_FRAMES_DIRTY;
+	}
+
+	void MaterialTable::Flush(std::uint32_t slot, std::size_t frame_index) noexcept
+	{
+		if(slot >= m_next_slot || !(m_dirty_frames[slot] & (1u << frame_index)))
+			return;
+		std::uint8_t* map = static_cast<std::uint8_t*>(m_buffer.GetMap());
+		std::memcpy(map + GetSlotOffset(slot, frame_index), m_shadow.data() + slot * m_stride, m_slot_size);
+		m_dirty_frames[slot] &= ~static_cast<std::uint8_t>(1u << frame_index);
+	}
+
+	void MaterialTable::Destroy() noexcept
+	{
+		m_buffer.Destroy();
+		m_shadow.clear();
+		m_dirty_frames.clear();
+		m_free_slots.clear();
+		m_capacity = 0;
+		m_next_slot = 0;
+		Message("Vulkan: material table destroyed");
+	}
+}
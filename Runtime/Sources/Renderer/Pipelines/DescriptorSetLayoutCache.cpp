@@ -0,0 +1,66 @@
+#include <Renderer/Pipelines/DescriptorSetLayoutCache.h>
+#include <Renderer/RenderCore.h>
+#include <Core/Logs.h>
+
+#include <vector>
+#include <algorithm>
+
+namespace Scop
+{
+	std::size_t HashShaderSetLayout(const ShaderSetLayout& layout, VkShaderStageFlags stages) noexcept
+	{
+		std::vector<std::pair<int, VkDescriptorType>> binds(layout.binds.begin(), layout.binds.end());
+		std::sort(binds.begin(), binds.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		std::size_t hash = std::hash<std::uint32_t>{}(stages);
+		for(const auto& [binding, type] : binds)
+		{
+			hash ^= std::hash<int>{}(binding) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<int>{}(static_cast<int>(type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<std::uint32_t>{}(layout.GetDescriptorCount(binding)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+
+	VkDescriptorSetLayout DescriptorSetLayoutCache::Get(const ShaderSetLayout& layout, VkShaderStageFlags stages)
+	{
+		std::size_t hash = HashShaderSetLayout(layout, stages);
+		auto [begin, end] = m_layouts.equal_range(hash);
+		for(auto it = begin; it != end; ++it)
+		{
+			if(it->second.stages == stages && it->second.layout == layout)
+				return it->second.vulkan_layout;
+		}
+
+		std::vector<VkDescriptorSetLayoutBinding> bindings(layout.binds.size());
+		std::size_t i = 0;
+		for(auto& [bind, type] : layout.binds)
+		{
+			bindings[i].binding = bind;
+			bindings[i].descriptorCount = layout.GetDescriptorCount(bind);
+			if(bindings[i].descriptorCount == SHADER_UNBOUNDED_DESCRIPTOR_COUNT)
+			{
+				Error("Vulkan: runtime descriptor arrays are only supported by the bindless texture table, binding % gets a single descriptor", bind);
+				bindings[i].descriptorCount = 1;
+			}
+			bindings[i].descriptorType = type;
+			bindings[i].pImmutableSamplers = nullptr;
+			bindings[i].stageFlags = stages;
+			i++;
+		}
+		VkDescriptorSetLayout vulkan_layout = kvfCreateDescriptorSetLayout(RenderCore::Get().GetDevice(), bindings.data(), bindings.size());
+		Message("Vulkan: descriptor set layout created");
+		m_layouts.emplace(hash, Entry{ layout, stages, vulkan_layout });
+		return vulkan_layout;
+	}
+
+	void DescriptorSetLayoutCache::Destroy() noexcept
+	{
+		for(auto& [_, entry] : m_layouts)
+		{
+			kvfDestroyDescriptorSetLayout(RenderCore::Get().GetDevice(), entry.vulkan_layout);
+			Message("Vulkan: descriptor set layout destroyed");
+		}
+		m_layouts.clear();
+	}
+}
@@ -1,4 +1,7 @@
 #include <Renderer/Pipelines/Graphics.h>
+#include <Renderer/Pipelines/PipelineCompiler.h>
+#include <Renderer/Pipelines/DescriptorSetLayoutCache.h>
+#include <Renderer/BindlessTextureTable.h>
 #include <Renderer/RenderCore.h>
 #include <Renderer/Renderer.h>
 #include <Renderer/Vertex.h>
@@ -8,22 +11,49 @@
 
 namespace Scop
 {
-	void GraphicPipeline::Init(GraphicPipelineDescriptor descriptor)
+	std::vector<VkDescriptorSetLayout> GraphicPipeline::MergeSetLayouts() const
+	{
+		const Shader& vertex_shader = *m_description.vertex_shader;
+		const Shader& fragment_shader = *m_description.fragment_shader;
+		std::map<int, VkDescriptorSetLayout> merged = vertex_shader.GetPipelineLayout().set_layouts;
+		for(const auto& [index, layout] : fragment_shader.GetPipelineLayout().set_layouts)
+		{
+			// Descriptor sets are allocated from a single stage layout, a set shared by both stages would never be compatible
+			if(!merged.emplace(index, layout).second)
+				FatalError("Vulkan: vertex and fragment shaders of % both use descriptor set %, stages must use distinct sets", m_description.name, index);
+		}
+
+		std::vector<VkDescriptorSetLayout> set_layouts;
+		if(merged.empty())
+			return set_layouts;
+		// Pipeline layouts index sets by position, unused sets in between still need a layout
+		set_layouts.resize(merged.rbegin()->first + 1, VK_NULL_HANDLE);
+		for(const auto& [index, layout] : merged)
+			set_layouts[index] = layout;
+		for(auto& layout : set_layouts)
+		{
+			if(layout == VK_NULL_HANDLE)
+				layout = RenderCore::Get().GetDescriptorSetLayoutCache().Get(ShaderSetLayout({}), 0);
+		}
+		return set_layouts;
+	}
+
+	void GraphicPipeline::Init(GraphicPipelineDescriptor descriptor, bool async)
 	{
 		Setup(std::move(descriptor));
 
 		m_description.vertex_shader->SetPipelineInUse(this);
 		m_description.fragment_shader->SetPipelineInUse(this);
 
-		std::vector<VkPushConstantRange> push_constants;
-		std::vector<VkDescriptorSetLayout> set_layouts;
-		push_constants.insert(push_constants.end(), m_description.vertex_shader->GetPipelineLayout().push_constants.begin(), m_description.vertex_shader->GetPipelineLayout().push_constants.end());
-		push_constants.insert(push_constants.end(), m_description.fragment_shader->GetPipelineLayout().push_constants.begin(), m_description.fragment_shader->GetPipelineLayout().push_constants.end());
-		set_layouts.insert(set_layouts.end(), m_description.vertex_shader->GetPipelineLayout().set_layouts.begin(), m_description.vertex_shader->GetPipelineLayout().set_layouts.end());
-		set_layouts.insert(set_layouts.end(), m_description.fragment_shader->GetPipelineLayout().set_layouts.begin(), m_description.fragment_shader->GetPipelineLayout().set_layouts.end());
-		m_pipeline_layout = kvfCreatePipelineLayout(RenderCore::Get().GetDevice(), set_layouts.data(), set_layouts.size(), push_constants.data(), push_constants.size());
+		m_push_constants.clear();
+		m_push_constants.insert(m_push_constants.end(), m_description.vertex_shader->GetPipelineLayout().push_constants.begin(), m_description.vertex_shader->GetPipelineLayout().push_constants.end());
+		m_push_constants.insert(m_push_constants.end(), m_description.fragment_shader->GetPipelineLayout().push_constants.begin(), m_description.fragment_shader->GetPipelineLayout().push_constants.end());
+		std::vector<VkDescriptorSetLayout> set_layouts = MergeSetLayouts();
+		m_pipeline_layout = kvfCreatePipelineLayout(RenderCore::Get().GetDevice(), set_layouts.data(), set_layouts.size(), m_push_constants.data(), m_push_constants.size());
+		m_uses_bindless_textures = RenderCore::Get().IsBindlessEnabled() && m_description.fragment_shader->GetPipelineLayout().set_layouts.contains(BINDLESS_TEXTURE_SET);
 
-		CreateFramebuffers(m_description.color_attachments, m_description.clear_color_attachments);
+		CreateRenderPass(m_description.clear_color_attachments);
+		CreateFramebuffers();
 
 		VkPhysicalDeviceFeatures features{};
 		RenderCore::Get().vkGetPhysicalDeviceFeatures(RenderCore::Get().GetPhysicalDevice(), &features);
@@ -65,9 +95,39 @@ namespace Scop
 			kvfGPipelineBuilderSetVertexInputs(builder, binding_description, attributes_description.data(), attributes_description.size());
 		}
 
-		m_pipeline = kvfCreateGraphicsPipeline(RenderCore::Get().GetDevice(), VK_NULL_HANDLE, m_pipeline_layout, builder, m_renderpass);
+		if(async)
+		{
+			VkDevice device = RenderCore::Get().GetDevice();
+			VkPipelineCache cache = RenderCore::Get().GetPipelineCache();
+			VkPipelineLayout layout = m_pipeline_layout;
+			VkRenderPass renderpass = m_renderpass;
+			m_pending_pipeline = RenderCore::Get().GetPipelineCompiler().Submit([device, cache, layout, builder, renderpass]()
+			{
+				VkPipeline pipeline = kvfCreateGraphicsPipeline(device, cache, layout, builder, renderpass);
+				kvfDestroyGPipelineBuilder(builder);
+				return pipeline;
+			});
+			return;
+		}
+
+		m_pipeline = kvfCreateGraphicsPipeline(RenderCore::Get().GetDevice(), RenderCore::Get().GetPipelineCache(), m_pipeline_layout, builder, m_renderpass);
 		kvfDestroyGPipelineBuilder(builder);
+		OnPipelineCreated();
+	}
+
+	bool GraphicPipeline::IsReady() noexcept
+	{
+		if(m_pipeline != VK_NULL_HANDLE)
+			return true;
+		if(!m_pending_pipeline.valid() || m_pending_pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return false;
+		m_pipeline = m_pending_pipeline.get();
+		OnPipelineCreated();
+		return true;
+	}
 
+	void GraphicPipeline::OnPipelineCreated()
+	{
 		#ifdef SCOP_HAS_DEBUG_UTILS_FUNCTIONS
 			VkDebugUtilsObjectNameInfoEXT name_info{};
 			name_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -107,6 +167,13 @@ namespace Scop
 			return false;
 		}
 
+		// Attachments have been recreated at a new size, the renderpass and the pipeline are still valid
+		if(m_framebuffers_dirty)
+		{
+			DestroyFramebuffers();
+			CreateFramebuffers();
+		}
+
 		s_bound_pipeline = this;
 		TransitionAttachments(command_buffer);
 
@@ -151,17 +218,26 @@ namespace Scop
 		s_bound_pipeline = nullptr;
 	}
 
+	VkShaderStageFlags GraphicPipeline::GetPushConstantStages(std::uint32_t offset, std::uint32_t size) const noexcept
+	{
+		VkShaderStageFlags stages = 0;
+		for(const VkPushConstantRange& range : m_push_constants)
+		{
+			if(range.offset < offset + size && offset < range.offset + range.size)
+				stages |= range.stageFlags;
+		}
+		return stages;
+	}
+
 	void GraphicPipeline::Destroy() noexcept
 	{
+		if(m_pending_pipeline.valid())
+			m_pipeline = m_pending_pipeline.get();
 		if(m_pipeline == VK_NULL_HANDLE)
 			return;
 		RenderCore::Get().WaitDeviceIdle();
 
-		for(auto& fb : m_framebuffers)
-		{
-			kvfDestroyFramebuffer(RenderCore::Get().GetDevice(), fb);
-			Message("Vulkan: framebuffer destroyed");
-		}
+		DestroyFramebuffers();
 
 		kvfDestroyPipelineLayout(RenderCore::Get().GetDevice(), m_pipeline_layout);
 		Message("Vulkan: graphics pipeline layout destroyed");
@@ -172,42 +248,45 @@ namespace Scop
 		m_description.vertex_shader.reset();
 		m_description.fragment_shader.reset();
 		m_description.color_attachments.clear();
-		m_framebuffers.clear();
 		m_clears.clear();
+		m_attachment_generations.clear();
+		m_push_constants.clear();
+		m_framebuffers_dirty = false;
+		m_uses_bindless_textures = false;
 		m_renderpass = VK_NULL_HANDLE;
 		m_pipeline = VK_NULL_HANDLE;
 		m_pipeline_layout = VK_NULL_HANDLE;
 		Message("Vulkan: graphics pipeline destroyed");
 	}
 
-	void GraphicPipeline::CreateFramebuffers(const std::vector<NonOwningPtr<Texture>>& render_targets, bool clear_attachments)
+	void GraphicPipeline::CreateRenderPass(bool clear_attachments)
 	{
 		TransitionAttachments();
 
 		std::vector<VkAttachmentDescription> attachments;
-		std::vector<VkImageView> attachment_views;
 		if(m_description.renderer)
-		{
 			attachments.push_back(kvfBuildSwapchainAttachmentDescription(m_description.renderer->GetSwapchain().Get(), clear_attachments));
-			attachment_views.push_back(m_description.renderer->GetSwapchain().GetSwapchainImages()[0].GetImageView());
-		}
-
-		for(NonOwningPtr<Texture> image : render_targets)
-		{
+		for(NonOwningPtr<Texture> image : m_description.color_attachments)
 			attachments.push_back(kvfBuildAttachmentDescription(KVF_IMAGE_COLOR, image->GetFormat(), image->GetLayout(), image->GetLayout(), clear_attachments, VK_SAMPLE_COUNT_1_BIT));
-			attachment_views.push_back(image->GetImageView());
-		}
-
 		if(m_description.depth)
-		{
 			attachments.push_back(kvfBuildAttachmentDescription(KVF_IMAGE_DEPTH, m_description.depth->GetFormat(), m_description.depth->GetLayout(), m_description.depth->GetLayout(), clear_attachments, VK_SAMPLE_COUNT_1_BIT));
-			attachment_views.push_back(m_description.depth->GetImageView());
-		}
 
 		m_renderpass = kvfCreateRenderPass(RenderCore::Get().GetDevice(), attachments.data(), attachments.size(), GetPipelineBindPoint());
 		m_clears.clear();
 		m_clears.resize(attachments.size());
 		Message("Vulkan: renderpass created");
+	}
+
+	void GraphicPipeline::CreateFramebuffers()
+	{
+		// No layout transition here, framebuffers can be rebuilt mid-frame and BindPipeline records them in the frame command buffer
+		std::vector<VkImageView> attachment_views;
+		if(m_description.renderer)
+			attachment_views.push_back(m_description.renderer->GetSwapchain().GetSwapchainImages()[0].GetImageView());
+		for(NonOwningPtr<Texture> image : m_description.color_attachments)
+			attachment_views.push_back(image->GetImageView());
+		if(m_description.depth)
+			attachment_views.push_back(m_description.depth->GetImageView());
 
 		if(m_description.renderer)
 		{
@@ -218,11 +297,28 @@ namespace Scop
 				Message("Vulkan: framebuffer created");
 			}
 		}
-		for(NonOwningPtr<Texture> image : render_targets)
+		for(NonOwningPtr<Texture> image : m_description.color_attachments)
 		{
 			m_framebuffers.push_back(kvfCreateFramebuffer(RenderCore::Get().GetDevice(), m_renderpass, attachment_views.data(), attachment_views.size(), { .width = image->GetWidth(), .height = image->GetHeight() }));
 			Message("Vulkan: framebuffer created");
 		}
+
+		m_attachment_generations.clear();
+		for(NonOwningPtr<Texture> image : m_description.color_attachments)
+			m_attachment_generations.push_back(image->GetGeneration());
+		if(m_description.depth)
+			m_attachment_generations.push_back(m_description.depth->GetGeneration());
+		m_framebuffers_dirty = false;
+	}
+
+	void GraphicPipeline::DestroyFramebuffers()
+	{
+		for(auto& fb : m_framebuffers)
+		{
+			kvfDestroyFramebuffer(RenderCore::Get().GetDevice(), fb);
+			Message("Vulkan: framebuffer destroyed");
+		}
+		m_framebuffers.clear();
 	}
 
 	void GraphicPipeline::TransitionAttachments(VkCommandBuffer cmd)
@@ -0,0 +1,117 @@
+#include <Renderer/Pipelines/PipelineCache.h>
+#include <Core/Logs.h>
+
+#include <vector>
+#include <functional>
+
+namespace Scop
+{
+	namespace Internal
+	{
+		inline void HashCombine(std::size_t& seed, std::size_t value) noexcept
+		{
+			seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		}
+
+		std::vector<std::uint64_t> GetAttachmentGenerations(const GraphicPipelineDescriptor& descriptor)
+		{
+			std::vector<std::uint64_t> generations;
+			for(NonOwningPtr<Texture> image : descriptor.color_attachments)
+				generations.push_back(image->GetGeneration());
+			if(descriptor.depth)
+				generations.push_back(descriptor.depth->GetGeneration());
+			return generations;
+		}
+
+		// A destroyed attachment may have its address reused by another texture, the framebuffers would then point to dead views.
+		// Dirty framebuffers are rebuilt from the current attachments on next bind so they cannot be stale
+		bool AreFramebuffersUpToDate(const GraphicPipeline& pipeline, const std::vector<std::uint64_t>& generations)
+		{
+			return pipeline.AreFramebuffersDirty() || pipeline.GetAttachmentGenerations() == generations;
+		}
+	}
+
+	std::size_t HashGraphicPipelineDescriptor(const GraphicPipelineDescriptor& descriptor) noexcept
+	{
+		std::size_t hash = 0;
+		Internal::HashCombine(hash, std::hash<const void*>{}(descriptor.vertex_shader.get()));
+		Internal::HashCombine(hash, std::hash<const void*>{}(descriptor.fragment_shader.get()));
+		for(NonOwningPtr<Texture> image : descriptor.color_attachments)
+		{
+			Internal::HashCombine(hash, std::hash<const void*>{}(image.Get()));
+			Internal::HashCombine(hash, static_cast<std::size_t>(image->GetFormat()));
+		}
+		if(descriptor.depth)
+		{
+			Internal::HashCombine(hash, std::hash<const void*>{}(descriptor.depth.Get()));
+			Internal::HashCombine(hash, static_cast<std::size_t>(descriptor.depth->GetFormat()));
+		}
+		Internal::HashCombine(hash, std::hash<const void*>{}(descriptor.renderer.Get()));
+		Internal::HashCombine(hash, static_cast<std::size_t>(descriptor.culling));
+		Internal::HashCombine(hash, static_cast<std::size_t>(descriptor.no_vertex_inputs));
+		Internal::HashCombine(hash, static_cast<std::size_t>(descriptor.depth_test_equal));
+		Internal::HashCombine(hash, static_cast<std::size_t>(descriptor.clear_color_attachments));
+		Internal::HashCombine(hash, static_cast<std::size_t>(descriptor.wireframe));
+		return hash;
+	}
+
+	bool AreGraphicPipelineDescriptorsCompatible(const GraphicPipelineDescriptor& lhs, const GraphicPipelineDescriptor& rhs) noexcept
+	{
+		if(lhs.color_attachments.size() != rhs.color_attachments.size())
+			return false;
+		for(std::size_t i = 0; i < lhs.color_attachments.size(); i++)
+		{
+			if(lhs.color_attachments[i].Get() != rhs.color_attachments[i].Get())
+				return false;
+		}
+		// Name is only a debug label and does not take part in the comparison
+		return lhs.vertex_shader == rhs.vertex_shader &&
+			lhs.fragment_shader == rhs.fragment_shader &&
+			lhs.depth.Get() == rhs.depth.Get() &&
+			lhs.renderer.Get() == rhs.renderer.Get() &&
+			lhs.culling == rhs.culling &&
+			lhs.no_vertex_inputs == rhs.no_vertex_inputs &&
+			lhs.depth_test_equal == rhs.depth_test_equal &&
+			lhs.clear_color_attachments == rhs.clear_color_attachments &&
+			lhs.wireframe == rhs.wireframe;
+	}
+
+	std::shared_ptr<GraphicPipeline> GraphicPipelineCache::RequestPipeline(GraphicPipelineDescriptor descriptor, bool async)
+	{
+		std::size_t hash = HashGraphicPipelineDescriptor(descriptor);
+		std::vector<std::uint64_t> generations = Internal::GetAttachmentGenerations(descriptor);
+		auto [begin, end] = m_pipelines.equal_range(hash);
+		for(auto it = begin; it != end; ++it)
+		{
+			std::shared_ptr<GraphicPipeline> pipeline = it->second.lock();
+			if(!pipeline || (pipeline->GetPipeline() == VK_NULL_HANDLE && !pipeline->IsCompiling()))
+				continue;
+			if(AreGraphicPipelineDescriptorsCompatible(pipeline->GetDescription(), descriptor) && Internal::AreFramebuffersUpToDate(*pipeline, generations))
+				return pipeline;
+		}
+
+		CollectGarbage();
+
+		std::shared_ptr<GraphicPipeline> pipeline = std::make_shared<GraphicPipeline>();
+		pipeline->Init(std::move(descriptor), async);
+		m_pipelines.emplace(hash, pipeline);
+		return pipeline;
+	}
+
+	void GraphicPipelineCache::CollectGarbage()
+	{
+		for(auto it = m_pipelines.begin(); it != m_pipelines.end();)
+		{
+			if(it->second.expired())
+				it = m_pipelines.erase(it);
+			else
+				++it;
+		}
+	}
+
+	void GraphicPipelineCache::Destroy() noexcept
+	{
+		// Pipelines are owned by their users, the cache only forgets about them
+		m_pipelines.clear();
+	}
+}
@@ -0,0 +1,65 @@
+#include <Renderer/Pipelines/PipelineCompiler.h>
+#include <Core/Logs.h>
+
+#include <algorithm>
+
+namespace Scop
+{
+	void PipelineCompiler::Init(std::size_t workers_count)
+	{
+		if(workers_count == 0)
+			workers_count = std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+		m_stop = false;
+		for(std::size_t i = 0; i < workers_count; i++)
+			m_workers.emplace_back(&PipelineCompiler::WorkerLoop, this);
+		Message("Vulkan: pipeline compiler started with % workers", workers_count);
+	}
+
+	std::future<VkPipeline> PipelineCompiler::Submit(std::function<VkPipeline()> job)
+	{
+		std::packaged_task<VkPipeline()> task(std::move(job));
+		std::future<VkPipeline> future = task.get_future();
+		if(m_workers.empty())
+		{
+			task();
+			return future;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push(std::move(task));
+		}
+		m_condition.notify_one();
+		return future;
+	}
+
+	void PipelineCompiler::WorkerLoop()
+	{
+		for(;;)
+		{
+			std::packaged_task<VkPipeline()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+				// Pending jobs are drained before exiting so no future is left broken
+				if(m_jobs.empty())
+					return;
+				task = std::move(m_jobs.front());
+				m_jobs.pop();
+			}
+			task();
+		}
+	}
+
+	void PipelineCompiler::Destroy() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_all();
+		for(std::thread& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+		Message("Vulkan: pipeline compiler stopped");
+	}
+}
@@ -1,11 +1,25 @@
 #include <Renderer/Pipelines/Shader.h>
+#include <Renderer/Pipelines/ShaderReflection.h>
+#include <Renderer/Pipelines/ShaderArchive.h>
+#include <Renderer/Pipelines/DescriptorSetLayoutCache.h>
+#include <Renderer/BindlessTextureTable.h>
 #include <Renderer/RenderCore.h>
 #include <Core/Logs.h>
 #include <fstream>
 
 namespace Scop
 {
-	Shader::Shader(const std::vector<std::uint32_t>& bytecode, ShaderType type, ShaderLayout layout, std::string name) : m_name(std::move(name)), m_bytecode(bytecode), m_layout(std::move(layout))
+	Shader::Shader(std::vector<std::uint32_t> bytecode, ShaderType type, ShaderLayout layout, std::string name) : m_name(std::move(name)), m_layout(std::move(layout)), m_bytecode(std::move(bytecode))
+	{
+		CreateModule(m_bytecode, type);
+	}
+
+	Shader::Shader(std::span<const std::uint32_t> bytecode, ShaderType type, ShaderLayout layout, std::string name) : m_name(std::move(name)), m_layout(std::move(layout))
+	{
+		CreateModule(bytecode, type);
+	}
+
+	void Shader::CreateModule(std::span<const std::uint32_t> bytecode, ShaderType type)
 	{
 		switch(type)
 		{
@@ -14,7 +28,8 @@ namespace Scop
 			case ShaderType::Compute : m_stage = VK_SHADER_STAGE_COMPUTE_BIT; break;
 			default : FatalError("wtf"); break;
 		}
-		m_module = kvfCreateShaderModule(RenderCore::Get().GetDevice(), m_bytecode.data(), m_bytecode.size());
+		// KVF only reads the code
+		m_module = kvfCreateShaderModule(RenderCore::Get().GetDevice(), const_cast<std::uint32_t*>(bytecode.data()), bytecode.size());
 		Message("Vulkan: shader module % created", m_name);
 
 		#ifdef SCOP_HAS_DEBUG_UTILS_FUNCTIONS
@@ -31,22 +46,17 @@ namespace Scop
 
 	void Shader::GeneratePipelineLayout(ShaderLayout layout)
 	{
-		for(auto& [_, set] : layout.set_layouts)
+		for(auto& [index, set] : layout.set_layouts)
 		{
-			std::vector<VkDescriptorSetLayoutBinding> bindings(set.binds.size());
-			std::size_t i = 0;
-			for(auto& [bind, type] : set.binds)
+			// The bindless set is allocated once with update after bind flags, its layout must be the table one
+			if(index == BINDLESS_TEXTURE_SET && RenderCore::Get().IsBindlessEnabled())
 			{
-				bindings[i].binding = bind;
-				bindings[i].descriptorCount = 1;
-				bindings[i].descriptorType = type;
-				bindings[i].pImmutableSamplers = nullptr;
-				bindings[i].stageFlags = m_stage;
-				i++;
+				if(set.binds.size() != 1 || !set.binds.contains(0) || set.binds.at(0) != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+					FatalError("Vulkan: shader % declares set % which is reserved to the bindless texture table", m_name, index);
+				m_pipeline_layout_part.set_layouts[index] = RenderCore::Get().GetBindlessTextureTable().GetLayout();
+				continue;
 			}
-			m_set_layouts.emplace_back(kvfCreateDescriptorSetLayout(RenderCore::Get().GetDevice(), bindings.data(), bindings.size()));
-			Message("Vulkan: descriptor set layout created");
-			m_pipeline_layout_part.set_layouts.push_back(m_set_layouts.back());
+			m_pipeline_layout_part.set_layouts[index] = RenderCore::Get().GetDescriptorSetLayoutCache().Get(set, m_stage);
 		}
 
 		std::size_t i = 0;
@@ -71,11 +81,6 @@ namespace Scop
 		kvfDestroyShaderModule(RenderCore::Get().GetDevice(), m_module);
 		m_module = VK_NULL_HANDLE;
 		Message("Vulkan: shader module % destroyed", m_name);
-		for(auto& layout : m_set_layouts)
-		{
-			kvfDestroyDescriptorSetLayout(RenderCore::Get().GetDevice(), layout);
-			Message("Vulkan: descriptor set layout destroyed");
-		}
 	}
 
 	Shader::~Shader()
@@ -83,20 +88,53 @@ namespace Scop
 		Destroy();
 	}
 
+	namespace Internal
+	{
+		std::vector<std::uint32_t> ReadShaderBytecode(const std::filesystem::path& filepath)
+		{
+			std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+			if(!stream.is_open())
+				FatalError("Renderer : unable to open a spirv shader file, %", filepath);
+			std::size_t size = stream.tellg();
+			if(size % sizeof(std::uint32_t) != 0)
+				FatalError("Renderer : invalid spirv shader file size, %", filepath);
+			std::vector<std::uint32_t> data(size / sizeof(std::uint32_t));
+			stream.seekg(0);
+			if(!stream.read(reinterpret_cast<char*>(data.data()), size))
+				FatalError("Renderer : unable to read a spirv shader file, %", filepath);
+			return data;
+		}
+	}
+
 	std::shared_ptr<Shader> LoadShaderFromFile(const std::filesystem::path& filepath, ShaderType type, ShaderLayout layout)
 	{
-		std::ifstream stream(filepath, std::ios::binary);
-		if(!stream.is_open())
-			FatalError("Renderer : unable to open a spirv shader file, %", filepath);
-		std::vector<std::uint32_t> data;
-		stream.seekg(0);
-		std::uint32_t part = 0;
-		while(stream.read(reinterpret_cast<char*>(&part), sizeof(part)))
-			data.push_back(part);
-		stream.close();
+		std::vector<std::uint32_t> data = Internal::ReadShaderBytecode(filepath);
+		std::shared_ptr<Shader> shader = std::make_shared<Shader>(std::move(data), type, layout, filepath.stem().string());
+		Message("Vulkan: shader loaded %", filepath);
+		return shader;
+	}
 
-		std::shared_ptr<Shader> shader = std::make_shared<Shader>(data, type, layout, filepath.stem().string());
+	std::shared_ptr<Shader> LoadShaderFromFile(const std::filesystem::path& filepath, ShaderType type)
+	{
+		std::vector<std::uint32_t> data = Internal::ReadShaderBytecode(filepath);
+		std::optional<ShaderLayout> layout = ReflectShaderLayout(data);
+		if(!layout.has_value())
+			FatalError("Renderer : unable to reflect the layout of a spirv shader, %", filepath);
+		std::shared_ptr<Shader> shader = std::make_shared<Shader>(std::move(data), type, std::move(*layout), filepath.stem().string());
 		Message("Vulkan: shader loaded %", filepath);
 		return shader;
 	}
+
+	std::shared_ptr<Shader> LoadShaderFromArchive(const ShaderArchive& archive, const std::string& name, ShaderType type)
+	{
+		std::span<const std::uint32_t> bytecode = archive.GetBytecode(name);
+		if(bytecode.empty())
+			FatalError("Renderer : shader % not found in shader archive", name);
+		std::optional<ShaderLayout> layout = ReflectShaderLayout(bytecode.data(), bytecode.size());
+		if(!layout.has_value())
+			FatalError("Renderer : unable to reflect the layout of a spirv shader, %", name);
+		std::shared_ptr<Shader> shader = std::make_shared<Shader>(bytecode, type, std::move(*layout), name);
+		Message("Vulkan: shader loaded % from archive", name);
+		return shader;
+	}
 }
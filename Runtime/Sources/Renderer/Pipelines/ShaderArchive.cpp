@@ -0,0 +1,204 @@
+#include <Renderer/Pipelines/ShaderArchive.h>
+#include <Core/Logs.h>
+
+#include <fstream>
+#include <algorithm>
+
+namespace Scop
+{
+	namespace Internal
+	{
+		constexpr const std::uint32_t SHADER_ARCHIVE_MAGIC = 0x41534353; // 'SCSA'
+		constexpr const std::uint32_t SHADER_ARCHIVE_VERSION = 1;
+		constexpr const std::uint32_t SHADER_ARCHIVE_MAX_NAME_LENGTH = 256;
+
+		struct ShaderArchiveHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t entries_count;
+			std::uint32_t data_words_count;
+		};
+
+		// Followed by the name, padded to a multiple of four bytes
+		struct ShaderArchiveEntryHeader
+		{
+			std::uint32_t offset;
+			std::uint32_t words_count;
+			std::uint32_t name_length;
+		};
+
+		std::vector<std::filesystem::path> GetSpirvFiles(const std::filesystem::path& directory)
+		{
+			std::vector<std::filesystem::path> files;
+			std::error_code ec;
+			for(const auto& entry : std::filesystem::directory_iterator(directory, ec))
+			{
+				if(entry.is_regular_file() && entry.path().extension() == ".spv")
+					files.push_back(entry.path());
+			}
+			std::sort(files.begin(), files.end());
+			return files;
+		}
+
+		constexpr std::uint32_t PadToWord(std::uint32_t size) noexcept
+		{
+			return (size + 3) & ~3u;
+		}
+	}
+
+	bool ShaderArchive::Pack(const std::filesystem::path& directory, const std::filesystem::path& archive_path)
+	{
+		std::vector<std::filesystem::path> files = Internal::GetSpirvFiles(directory);
+		if(files.empty())
+			return false;
+
+		std::vector<std::string> names;
+		std::vector<Internal::ShaderArchiveEntryHeader> entries;
+		std::vector<std::uint32_t> data;
+		for(const auto& file : files)
+		{
+			std::ifstream stream(file, std::ios::binary | std::ios::ate);
+			if(!stream.is_open())
+			{
+				Error("Renderer: unable to open a spirv shader file while packing shaders, %", file);
+				return false;
+			}
+			std::size_t size = stream.tellg();
+			std::string name = file.stem().string();
+			if(size % sizeof(std::uint32_t) != 0 || name.size() > Internal::SHADER_ARCHIVE_MAX_NAME_LENGTH)
+			{
+				Error("Renderer: invalid spirv shader file, %", file);
+				return false;
+			}
+			Internal::ShaderArchiveEntryHeader entry{};
+			entry.offset = data.size();
+			entry.words_count = size / sizeof(std::uint32_t);
+			entry.name_length = name.size();
+			data.resize(data.size() + entry.words_count);
+			stream.seekg(0);
+			stream.read(reinterpret_cast<char*>(data.data() + entry.offset), size);
+			entries.push_back(entry);
+			names.push_back(std::move(name));
+		}
+
+		std::ofstream stream(archive_path, std::ios::binary | std::ios::trunc);
+		if(!stream.is_open())
+		{
+			Warning("Renderer: unable to write shader archive, %", archive_path);
+			return false;
+		}
+		Internal::ShaderArchiveHeader header{};
+		header.magic = Internal::SHADER_ARCHIVE_MAGIC;
+		header.version = Internal::SHADER_ARCHIVE_VERSION;
+		header.entries_count = entries.size();
+		header.data_words_count = data.size();
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		const char padding[4] = { 0, 0, 0, 0 };
+		for(std::size_t i = 0; i < entries.size(); i++)
+		{
+			stream.write(reinterpret_cast<const char*>(&entries[i]), sizeof(Internal::ShaderArchiveEntryHeader));
+			stream.write(names[i].data(), names[i].size());
+			stream.write(padding, Internal::PadToWord(names[i].size()) - names[i].size());
+		}
+		stream.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(std::uint32_t));
+		if(!stream)
+		{
+			Warning("Renderer: failed to write shader archive, %", archive_path);
+			return false;
+		}
+		Message("Renderer: packed % shaders into %", entries.size(), archive_path);
+		return true;
+	}
+
+	bool ShaderArchive::IsOutdated(const std::filesystem::path& directory, const std::filesystem::path& archive_path)
+	{
+		std::error_code ec;
+		auto archive_time = std::filesystem::last_write_time(archive_path, ec);
+		if(ec)
+			return true;
+		for(const auto& file : Internal::GetSpirvFiles(directory))
+		{
+			if(std::filesystem::last_write_time(file, ec) > archive_time)
+				return true;
+		}
+		return false;
+	}
+
+	bool ShaderArchive::Open(const std::filesystem::path& filepath)
+	{
+		Close();
+
+		std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+		if(!stream.is_open())
+			return false;
+		std::size_t size = stream.tellg();
+		if(size < sizeof(Internal::ShaderArchiveHeader) || size % sizeof(std::uint32_t) != 0)
+		{
+			Warning("Renderer: invalid shader archive, %", filepath);
+			return false;
+		}
+		// Whole archive in one read, the bytecode is then used in place
+		std::vector<std::uint32_t> file(size / sizeof(std::uint32_t));
+		stream.seekg(0);
+		if(!stream.read(reinterpret_cast<char*>(file.data()), size))
+			return false;
+
+		const Internal::ShaderArchiveHeader* header = reinterpret_cast<const Internal::ShaderArchiveHeader*>(file.data());
+		if(header->magic != Internal::SHADER_ARCHIVE_MAGIC || header->version != Internal::SHADER_ARCHIVE_VERSION)
+		{
+			Warning("Renderer: invalid shader archive, %", filepath);
+			return false;
+		}
+
+		std::size_t cursor = sizeof(Internal::ShaderArchiveHeader) / sizeof(std::uint32_t);
+		std::unordered_map<std::string, Entry> entries;
+		for(std::uint32_t i = 0; i < header->entries_count; i++)
+		{
+			if((cursor * sizeof(std::uint32_t)) + sizeof(Internal::ShaderArchiveEntryHeader) > size)
+				break;
+			const Internal::ShaderArchiveEntryHeader* entry = reinterpret_cast<const Internal::ShaderArchiveEntryHeader*>(file.data() + cursor);
+			cursor += sizeof(Internal::ShaderArchiveEntryHeader) / sizeof(std::uint32_t);
+			std::size_t name_words = Internal::PadToWord(entry->name_length) / sizeof(std::uint32_t);
+			if(entry->name_length > Internal::SHADER_ARCHIVE_MAX_NAME_LENGTH || cursor + name_words > file.size())
+				break;
+			std::string name(reinterpret_cast<const char*>(file.data() + cursor), entry->name_length);
+			cursor += name_words;
+			entries.emplace(std::move(name), Entry{ entry->offset, entry->words_count });
+		}
+		if(entries.size() != header->entries_count || cursor + header->data_words_count != file.size())
+		{
+			Warning("Renderer: shader archive is truncated, %", filepath);
+			return false;
+		}
+		for(auto& [name, entry] : entries)
+		{
+			if(entry.offset + entry.words_count > header->data_words_count)
+			{
+				Warning("Renderer: shader archive is corrupted, %", filepath);
+				return false;
+			}
+			entry.offset += cursor;
+		}
+
+		m_entries = std::move(entries);
+		m_data = std::move(file);
+		Message("Renderer: opened shader archive % (% shaders)", filepath, m_entries.size());
+		return true;
+	}
+
+	std::span<const std::uint32_t> ShaderArchive::GetBytecode(const std::string& name) const
+	{
+		auto it = m_entries.find(name);
+		if(it == m_entries.end())
+			return {};
+		return std::span<const std::uint32_t>(m_data.data() + it->second.offset, it->second.words_count);
+	}
+
+	void ShaderArchive::Close() noexcept
+	{
+		m_entries.clear();
+		m_data.clear();
+		m_data.shrink_to_fit();
+	}
+}
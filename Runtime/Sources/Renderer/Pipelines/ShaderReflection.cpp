@@ -0,0 +1,328 @@
+#include <Renderer/Pipelines/ShaderReflection.h>
+#include <Core/Logs.h>
+
+#include <limits>
+#include <algorithm>
+
+namespace Scop
+{
+	namespace Internal
+	{
+		constexpr const std::uint32_t SPIRV_MAGIC = 0x07230203;
+		constexpr const std::size_t SPIRV_HEADER_SIZE = 5;
+
+		enum SpirvOp : std::uint16_t
+		{
+			SpirvOpTypeInt = 21,
+			SpirvOpTypeFloat = 22,
+			SpirvOpTypeVector = 23,
+			SpirvOpTypeMatrix = 24,
+			SpirvOpTypeImage = 25,
+			SpirvOpTypeSampler = 26,
+			SpirvOpTypeSampledImage = 27,
+			SpirvOpTypeArray = 28,
+			SpirvOpTypeRuntimeArray = 29,
+			SpirvOpTypeStruct = 30,
+			SpirvOpTypePointer = 32,
+			SpirvOpConstant = 43,
+			SpirvOpVariable = 59,
+			SpirvOpDecorate = 71,
+			SpirvOpMemberDecorate = 72,
+		};
+
+		enum SpirvDecoration : std::uint32_t
+		{
+			SpirvDecorationBlock = 2,
+			SpirvDecorationBufferBlock = 3,
+			SpirvDecorationArrayStride = 6,
+			SpirvDecorationMatrixStride = 7,
+			SpirvDecorationBinding = 33,
+			SpirvDecorationDescriptorSet = 34,
+			SpirvDecorationOffset = 35,
+		};
+
+		enum SpirvStorageClass : std::uint32_t
+		{
+			SpirvStorageClassUniformConstant = 0,
+			SpirvStorageClassUniform = 2,
+			SpirvStorageClassPushConstant = 9,
+			SpirvStorageClassStorageBuffer = 12,
+		};
+
+		constexpr const std::uint32_t SPIRV_DIM_BUFFER = 5;
+		constexpr const std::uint32_t SPIRV_DIM_SUBPASS_DATA = 6;
+
+		struct SpirvId
+		{
+			std::vector<std::uint32_t> operands; // Words following the result id
+			std::vector<std::uint32_t> member_offsets;
+			std::vector<std::uint32_t> member_matrix_strides;
+			std::uint32_t type_id = 0;
+			std::uint32_t storage_class = 0;
+			std::uint32_t array_stride = 0;
+			std::int32_t set = -1;
+			std::int32_t binding = -1;
+			std::uint16_t opcode = 0;
+			bool buffer_block = false;
+		};
+
+		class SpirvModule
+		{
+			public:
+				SpirvModule(std::uint32_t bound) : m_ids(bound) {}
+
+				[[nodiscard]] inline SpirvId* Get(std::uint32_t id) noexcept { return id < m_ids.size() ? &m_ids[id] : nullptr; }
+				[[nodiscard]] inline std::vector<SpirvId>& GetIds() noexcept { return m_ids; }
+
+				std::size_t GetTypeSize(std::uint32_t type_id, std::uint32_t matrix_stride = 0, int depth = 0)
+				{
+					SpirvId* type = Get(type_id);
+					if(type == nullptr || depth > 32)
+						return 0;
+					switch(type->opcode)
+					{
+						case SpirvOpTypeInt:
+						case SpirvOpTypeFloat: return type->operands.empty() ? 0 : type->operands[0] / 8;
+						case SpirvOpTypeVector: return type->operands.size() < 2 ? 0 : GetTypeSize(type->operands[0], 0, depth + 1) * type->operands[1];
+						case SpirvOpTypeMatrix:
+						{
+							if(type->operands.size() < 2)
+								return 0;
+							std::size_t column_size = (matrix_stride != 0 ? matrix_stride : GetTypeSize(type->operands[0], 0, depth + 1));
+							return column_size * type->operands[1];
+						}
+						case SpirvOpTypeArray:
+						{
+							if(type->operands.size() < 2)
+								return 0;
+							SpirvId* length = Get(type->operands[1]);
+							std::size_t count = (length != nullptr && !length->operands.empty() ? length->operands[0] : 0);
+							std::size_t stride = (type->array_stride != 0 ? type->array_stride : GetTypeSize(type->operands[0], matrix_stride, depth + 1));
+							return stride * count;
+						}
+						case SpirvOpTypeStruct:
+						{
+							std::size_t size = 0;
+							for(std::size_t i = 0; i < type->operands.size(); i++)
+							{
+								std::size_t offset = (i < type->member_offsets.size() ? type->member_offsets[i] : size);
+								std::uint32_t member_stride = (i < type->member_matrix_strides.size() ? type->member_matrix_strides[i] : 0);
+								size = std::max(size, offset + GetTypeSize(type->operands[i], member_stride, depth + 1));
+							}
+							return size;
+						}
+
+						default: return 0;
+					}
+				}
+
+				// Product of the array lengths around the descriptor type, SHADER_UNBOUNDED_DESCRIPTOR_COUNT for runtime arrays
+				std::uint32_t GetDescriptorCount(const SpirvId& variable)
+				{
+					SpirvId* pointer = Get(variable.type_id);
+					if(pointer == nullptr || pointer->operands.size() < 2)
+						return 1;
+					std::uint32_t count = 1;
+					SpirvId* type = Get(pointer->operands[1]);
+					for(int depth = 0; type != nullptr && !type->operands.empty() && depth < 32; depth++)
+					{
+						if(type->opcode == SpirvOpTypeRuntimeArray)
+							return SHADER_UNBOUNDED_DESCRIPTOR_COUNT;
+						if(type->opcode != SpirvOpTypeArray)
+							break;
+						SpirvId* length = (type->operands.size() > 1 ? Get(type->operands[1]) : nullptr);
+						if(length == nullptr || length->opcode != SpirvOpConstant || length->operands.empty())
+							return 1;
+						count *= length->operands[0];
+						type = Get(type->operands[0]);
+					}
+					return count;
+				}
+
+				std::optional<VkDescriptorType> GetDescriptorType(const SpirvId& variable)
+				{
+					SpirvId* pointer = Get(variable.type_id);
+					if(pointer == nullptr || pointer->opcode != SpirvOpTypePointer || pointer->operands.size() < 2)
+						return std::nullopt;
+					SpirvId* type = Get(pointer->operands[1]);
+					while(type != nullptr && (type->opcode == SpirvOpTypeArray || type->opcode == SpirvOpTypeRuntimeArray) && !type->operands.empty())
+						type = Get(type->operands[0]);
+					if(type == nullptr)
+						return std::nullopt;
+
+					switch(type->opcode)
+					{
+						case SpirvOpTypeSampledImage: return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+						case SpirvOpTypeSampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
+						case SpirvOpTypeImage:
+						{
+							if(type->operands.size() < 6)
+								return std::nullopt;
+							std::uint32_t dim = type->operands[1];
+							bool storage = type->operands[5] == 2;
+							if(dim == SPIRV_DIM_SUBPASS_DATA)
+								return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+							if(dim == SPIRV_DIM_BUFFER)
+								return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+							return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+						}
+						case SpirvOpTypeStruct:
+						{
+							if(variable.storage_class == SpirvStorageClassStorageBuffer || type->buffer_block)
+								return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+							return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+						}
+
+						default: return std::nullopt;
+					}
+				}
+
+			private:
+				std::vector<SpirvId> m_ids;
+		};
+	}
+
+	std::optional<ShaderLayout> ReflectShaderLayout(const std::uint32_t* bytecode, std::size_t words_count)
+	{
+		if(bytecode == nullptr || words_count < Internal::SPIRV_HEADER_SIZE || bytecode[0] != Internal::SPIRV_MAGIC)
+		{
+			Error("Shader reflection: invalid SPIR-V bytecode");
+			return std::nullopt;
+		}
+
+		Internal::SpirvModule module(bytecode[3]);
+
+		for(std::size_t i = Internal::SPIRV_HEADER_SIZE; i < words_count;)
+		{
+			std::uint16_t opcode = bytecode[i] & 0xFFFF;
+			std::uint16_t count = bytecode[i] >> 16;
+			if(count == 0 || i + count > words_count)
+			{
+				Error("Shader reflection: corrupted SPIR-V instruction stream");
+				return std::nullopt;
+			}
+			const std::uint32_t* words = bytecode + i;
+
+			switch(opcode)
+			{
+				case Internal::SpirvOpTypeInt:
+				case Internal::SpirvOpTypeFloat:
+				case Internal::SpirvOpTypeVector:
+				case Internal::SpirvOpTypeMatrix:
+				case Internal::SpirvOpTypeImage:
+				case Internal::SpirvOpTypeSampler:
+				case Internal::SpirvOpTypeSampledImage:
+				case Internal::SpirvOpTypeArray:
+				case Internal::SpirvOpTypeRuntimeArray:
+				case Internal::SpirvOpTypeStruct:
+				case Internal::SpirvOpTypePointer:
+				{
+					if(Internal::SpirvId* id = module.Get(words[1]))
+					{
+						id->opcode = opcode;
+						id->operands.assign(words + 2, words + count);
+					}
+					break;
+				}
+				case Internal::SpirvOpConstant:
+				case Internal::SpirvOpVariable:
+				{
+					if(count < 4)
+						break;
+					if(Internal::SpirvId* id = module.Get(words[2]))
+					{
+						id->opcode = opcode;
+						id->type_id = words[1];
+						id->storage_class = words[3];
+						id->operands.assign(words + 3, words + count);
+					}
+					break;
+				}
+				case Internal::SpirvOpDecorate:
+				{
+					Internal::SpirvId* id = module.Get(words[1]);
+					if(id == nullptr || count < 3)
+						break;
+					switch(words[2])
+					{
+						case Internal::SpirvDecorationBufferBlock: id->buffer_block = true; break;
+						case Internal::SpirvDecorationArrayStride: if(count > 3) id->array_stride = words[3]; break;
+						case Internal::SpirvDecorationBinding: if(count > 3) id->binding = static_cast<std::int32_t>(words[3]); break;
+						case Internal::SpirvDecorationDescriptorSet: if(count > 3) id->set = static_cast<std::int32_t>(words[3]); break;
+						default: break;
+					}
+					break;
+				}
+				case Internal::SpirvOpMemberDecorate:
+				{
+					Internal::SpirvId* id = module.Get(words[1]);
+					if(id == nullptr || count < 5)
+						break;
+					std::uint32_t member = words[2];
+					if(words[3] == Internal::SpirvDecorationOffset)
+					{
+						if(id->member_offsets.size() <= member)
+							id->member_offsets.resize(member + 1, 0);
+						id->member_offsets[member] = words[4];
+					}
+					else if(words[3] == Internal::SpirvDecorationMatrixStride)
+					{
+						if(id->member_matrix_strides.size() <= member)
+							id->member_matrix_strides.resize(member + 1, 0);
+						id->member_matrix_strides[member] = words[4];
+					}
+					break;
+				}
+
+				default: break;
+			}
+			i += count;
+		}
+
+		ShaderLayout layout({}, {});
+		std::size_t push_constant_begin = std::numeric_limits<std::size_t>::max();
+		std::size_t push_constant_end = 0;
+
+		for(Internal::SpirvId& id : module.GetIds())
+		{
+			if(id.opcode != Internal::SpirvOpVariable)
+				continue;
+
+			if(id.storage_class == Internal::SpirvStorageClassPushConstant)
+			{
+				Internal::SpirvId* pointer = module.Get(id.type_id);
+				if(pointer == nullptr || pointer->operands.size() < 2)
+					continue;
+				Internal::SpirvId* block = module.Get(pointer->operands[1]);
+				if(block == nullptr)
+					continue;
+				std::size_t begin = block->member_offsets.empty() ? 0 : *std::min_element(block->member_offsets.begin(), block->member_offsets.end());
+				push_constant_begin = std::min(push_constant_begin, begin);
+				push_constant_end = std::max(push_constant_end, module.GetTypeSize(pointer->operands[1]));
+				continue;
+			}
+
+			if(id.storage_class != Internal::SpirvStorageClassUniformConstant && id.storage_class != Internal::SpirvStorageClassUniform && id.storage_class != Internal::SpirvStorageClassStorageBuffer)
+				continue;
+			if(id.set < 0 || id.binding < 0)
+				continue;
+			std::optional<VkDescriptorType> type = module.GetDescriptorType(id);
+			if(!type.has_value())
+			{
+				Warning("Shader reflection: unsupported descriptor at set %, binding %", id.set, id.binding);
+				continue;
+			}
+			auto it = layout.set_layouts.find(id.set);
+			if(it == layout.set_layouts.end())
+				it = layout.set_layouts.emplace(id.set, ShaderSetLayout({})).first;
+			it->second.binds[id.binding] = *type;
+			if(std::uint32_t count = module.GetDescriptorCount(id); count != 1)
+				it->second.counts[id.binding] = count;
+		}
+
+		if(push_constant_end > push_constant_begin)
+			layout.push_constants.emplace_back(push_constant_begin, push_constant_end - push_constant_begin);
+
+		return layout;
+	}
+}
@@ -3,12 +3,26 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <charconv>
 
 #include <Core/Engine.h>
 #include <Platform/Window.h>
+#include <Graphics/Material.h>
 #include <Renderer/Descriptor.h>
+#include <Renderer/BindlessTextureTable.h>
+#include <Renderer/MaterialTable.h>
+#include <Renderer/TextureStreamer.h>
+#include <Graphics/GlyphCache.h>
 #include <Renderer/RenderCore.h>
 #include <Renderer/Pipelines/Shader.h>
+#include <Renderer/Pipelines/ShaderArchive.h>
+#include <Renderer/Pipelines/PipelineCache.h>
+#include <Renderer/Pipelines/PipelineCompiler.h>
+#include <Renderer/Pipelines/DescriptorSetLayoutCache.h>
 #include <Renderer/Vulkan/VulkanLoader.h>
 #include <Maths/Mat4.h>
 #include <Core/Logs.h>
@@ -70,6 +84,43 @@ namespace Scop
 		std::cout << std::endl;
 	}
 
+	namespace Internal
+	{
+		bool IsInstanceExtensionSupported(const char* name)
+		{
+			std::uint32_t count = 0;
+			RenderCore::Get().vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+			std::vector<VkExtensionProperties> extensions(count);
+			RenderCore::Get().vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data());
+			return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties& ext) { return std::strcmp(ext.extensionName, name) == 0; });
+		}
+
+		std::size_t GetTextureStreamingBudget()
+		{
+			auto option = CommandLineInterface::Get().GetOption("texture-budget");
+			if(!option)
+				return DEFAULT_TEXTURE_STREAMING_BUDGET;
+			std::size_t mebibytes = 0;
+			const char* end = option->data() + option->size();
+			auto [ptr, ec] = std::from_chars(option->data(), end, mebibytes);
+			if(ec != std::errc{} || ptr != end)
+			{
+				Warning("Vulkan: invalid texture streaming budget '%', using the default one", *option);
+				return DEFAULT_TEXTURE_STREAMING_BUDGET;
+			}
+			return mebibytes * 1024 * 1024;
+		}
+
+		bool IsDeviceExtensionSupported(VkPhysicalDevice physical_device, const char* name)
+		{
+			std::uint32_t count = 0;
+			RenderCore::Get().vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &count, nullptr);
+			std::vector<VkExtensionProperties> extensions(count);
+			RenderCore::Get().vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &count, extensions.data());
+			return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties& ext) { return std::strcmp(ext.extensionName, name) == 0; });
+		}
+	}
+
 	RenderCore* RenderCore::s_instance = nullptr;
 
 	RenderCore::RenderCore()
@@ -86,6 +137,10 @@ namespace Scop
 
 		LoadKVFGlobalVulkanFunctionPointers();
 
+		bool want_bindless = CommandLineInterface::Get().HasFlag("bindless");
+		if(want_bindless && Internal::IsInstanceExtensionSupported(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+			instance_extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
 		kvfSetErrorCallback(&ErrorCallback);
 		kvfSetWarningCallback(&WarningCallback);
 		kvfSetValidationErrorCallback(&ValidationErrorCallback);
@@ -108,10 +163,27 @@ namespace Scop
 		vkGetPhysicalDeviceProperties(m_physical_device, &props);
 		Message("Vulkan: physical device picked '%'", props.deviceName);
 
-		const char* device_extensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+		std::vector<const char*> device_extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 		VkPhysicalDeviceFeatures features{};
 		vkGetPhysicalDeviceFeatures(m_physical_device, &features);
-		m_device = kvfCreateDevice(m_physical_device, device_extensions, sizeof(device_extensions) / sizeof(device_extensions[0]), &features);
+
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features{};
+		indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		m_bindless_enabled = want_bindless && IsBindlessSupported();
+		if(m_bindless_enabled)
+		{
+			device_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			device_extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+			indexing_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+			indexing_features.runtimeDescriptorArray = VK_TRUE;
+		}
+		else if(want_bindless)
+			Warning("Vulkan: bindless textures requested but descriptor indexing or large enough push constants are not supported, falling back to per material descriptor sets");
+
+		m_device = kvfCreateDeviceWithNext(m_physical_device, device_extensions.data(), device_extensions.size(), &features, m_bindless_enabled ? &indexing_features : nullptr);
 		Message("Vulkan: logical device created");
 
 		loader->LoadDevice(m_device);
@@ -121,42 +193,36 @@ namespace Scop
 
 		m_allocator.AttachToDevice(m_device, m_physical_device);
 
-		p_descriptor_pool_manager = std::make_unique<DescriptorPoolManager>();
+		CreatePipelineCache();
 
-		ShaderLayout vertex_shader_layout(
-			{
-				{ 0,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }
-					})
-				}
-			}, { ShaderPushConstantLayout({ 0, sizeof(Mat4f) * 2 }) }
-		);
-		m_internal_shaders[DEFAULT_VERTEX_SHADER_ID] = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/ForwardVertex.spv", ShaderType::Vertex, std::move(vertex_shader_layout));
+		if(m_bindless_enabled)
+		{
+			p_bindless_texture_table = std::make_unique<BindlessTextureTable>();
+			p_bindless_texture_table->Init();
+		}
 
-		ShaderLayout default_fragment_shader_layout(
-			{
-				{ 1,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER },
-						{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }
-					})
-				}
-			}, {}
-		);
-		m_internal_shaders[DEFAULT_FRAGMENT_SHADER_ID] = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/ForwardDefaultFragment.spv", ShaderType::Fragment, std::move(default_fragment_shader_layout));
+		p_material_table = std::make_unique<MaterialTable>();
+		p_material_table->Init(sizeof(MaterialData));
 
-		ShaderLayout basic_fragment_shader_layout(
-			{
-				{ 1,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER },
-						{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }
-					})
-				}
-			}, {}
-		);
-		m_internal_shaders[BASIC_FRAGMENT_SHADER_ID] = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/ForwardBasicFragment.spv", ShaderType::Fragment, std::move(basic_fragment_shader_layout));
+		p_texture_streamer = std::make_unique<TextureStreamer>();
+		p_texture_streamer->Init(Internal::GetTextureStreamingBudget());
+
+		p_glyph_cache = std::make_unique<GlyphCache>();
+		p_glyph_cache->Init();
+
+		p_descriptor_set_layout_cache = std::make_unique<DescriptorSetLayoutCache>();
+		p_descriptor_pool_manager = std::make_unique<DescriptorPoolManager>();
+		p_transient_descriptor_allocator = std::make_unique<TransientDescriptorAllocator>();
+		p_graphic_pipeline_cache = std::make_unique<GraphicPipelineCache>();
+		p_pipeline_compiler = std::make_unique<PipelineCompiler>();
+		p_pipeline_compiler->Init();
+
+		OpenShaderArchive();
+		m_internal_shaders[DEFAULT_VERTEX_SHADER_ID] = LoadInternalShader("ForwardVertex", ShaderType::Vertex);
+		// Bindless variants read materials from the material table and textures from the bindless table
+		std::string variant = (m_bindless_enabled ? "Bindless" : "");
+		m_internal_shaders[DEFAULT_FRAGMENT_SHADER_ID] = LoadInternalShader("ForwardDefaultFragment" + variant, ShaderType::Fragment);
+		m_internal_shaders[BASIC_FRAGMENT_SHADER_ID] = LoadInternalShader("ForwardBasicFragment" + variant, ShaderType::Fragment);
 	}
 
 	#undef SCOP_LOAD_FUNCTION
@@ -256,16 +322,207 @@ namespace Scop
 
 #undef SCOP_LOAD_FUNCTION
 
+	namespace Internal
+	{
+		constexpr const std::uint32_t PIPELINE_CACHE_MAGIC = 0x50435353; // 'SCPC'
+		constexpr const std::uint32_t PIPELINE_CACHE_VERSION = 1;
+
+		struct PipelineCacheHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t vendor_id;
+			std::uint32_t device_id;
+			std::uint32_t driver_version;
+			std::uint8_t uuid[VK_UUID_SIZE];
+			std::uint64_t data_size;
+		};
+
+		PipelineCacheHeader MakePipelineCacheHeader(VkPhysicalDevice physical_device)
+		{
+			VkPhysicalDeviceProperties props;
+			RenderCore::Get().vkGetPhysicalDeviceProperties(physical_device, &props);
+
+			PipelineCacheHeader header{};
+			header.magic = PIPELINE_CACHE_MAGIC;
+			header.version = PIPELINE_CACHE_VERSION;
+			header.vendor_id = props.vendorID;
+			header.device_id = props.deviceID;
+			header.driver_version = props.driverVersion;
+			std::memcpy(header.uuid, props.pipelineCacheUUID, VK_UUID_SIZE);
+			return header;
+		}
+
+		std::filesystem::path GetPipelineCachePath()
+		{
+			return ScopEngine::Get().GetAssetsPath() / "pipeline_cache.bin";
+		}
+	}
+
+	void RenderCore::CreatePipelineCache()
+	{
+		std::vector<std::uint8_t> data;
+
+		std::ifstream file(Internal::GetPipelineCachePath(), std::ios::binary);
+		if(file.is_open())
+		{
+			Internal::PipelineCacheHeader expected = Internal::MakePipelineCacheHeader(m_physical_device);
+			Internal::PipelineCacheHeader header{};
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			if(file.gcount() == sizeof(header) &&
+				header.magic == expected.magic &&
+				header.version == expected.version &&
+				header.vendor_id == expected.vendor_id &&
+				header.device_id == expected.device_id &&
+				header.driver_version == expected.driver_version &&
+				std::memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) == 0)
+			{
+				std::error_code error;
+				std::uint64_t file_size = std::filesystem::file_size(Internal::GetPipelineCachePath(), error);
+				// The size comes from the disk, it is never trusted beyond what the file holds
+				if(error || header.data_size > file_size - sizeof(header))
+					Warning("Vulkan: pipeline cache file is truncated, ignoring it");
+				else
+				{
+					data.resize(header.data_size);
+					file.read(reinterpret_cast<char*>(data.data()), data.size());
+					if(static_cast<std::uint64_t>(file.gcount()) != header.data_size)
+					{
+						Warning("Vulkan: pipeline cache file is truncated, ignoring it");
+						data.clear();
+					}
+				}
+			}
+			else
+				Warning("Vulkan: pipeline cache file does not match current device or driver, ignoring it");
+		}
+
+		VkPipelineCacheCreateInfo info{};
+		info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		info.initialDataSize = data.size();
+		info.pInitialData = data.empty() ? nullptr : data.data();
+		if(vkCreatePipelineCache(m_device, &info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+		{
+			// Some drivers refuse corrupted initial data instead of ignoring it
+			info.initialDataSize = 0;
+			info.pInitialData = nullptr;
+			if(vkCreatePipelineCache(m_device, &info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+			{
+				Warning("Vulkan: failed to create pipeline cache");
+				m_pipeline_cache = VK_NULL_HANDLE;
+				return;
+			}
+		}
+		if(data.empty())
+			Message("Vulkan: pipeline cache created");
+		else
+			Message("Vulkan: pipeline cache created from disk (% bytes)", data.size());
+	}
+
+	void RenderCore::SavePipelineCache() const
+	{
+		if(m_pipeline_cache == VK_NULL_HANDLE)
+			return;
+
+		std::size_t size = 0;
+		if(vkGetPipelineCacheData(m_device, m_pipeline_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+			return;
+		std::vector<std::uint8_t> data(size);
+		if(vkGetPipelineCacheData(m_device, m_pipeline_cache, &size, data.data()) != VK_SUCCESS)
+		{
+			Warning("Vulkan: failed to retrieve pipeline cache data");
+			return;
+		}
+
+		Internal::PipelineCacheHeader header = Internal::MakePipelineCacheHeader(m_physical_device);
+		header.data_size = size;
+
+		std::ofstream file(Internal::GetPipelineCachePath(), std::ios::binary | std::ios::trunc);
+		if(!file.is_open())
+		{
+			Warning("Vulkan: failed to write pipeline cache to %", Internal::GetPipelineCachePath());
+			return;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(data.data()), size);
+		Message("Vulkan: pipeline cache saved (% bytes)", size);
+	}
+
+	bool RenderCore::IsBindlessSupported() const
+	{
+		if(vkGetPhysicalDeviceFeatures2KHR == nullptr)
+			return false;
+		if(!Internal::IsDeviceExtensionSupported(m_physical_device, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) || !Internal::IsDeviceExtensionSupported(m_physical_device, VK_KHR_MAINTENANCE3_EXTENSION_NAME))
+			return false;
+
+		// The bindless forward shaders push the material index after the two matrices, past the 128 bytes every device has
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties(m_physical_device, &props);
+		if(props.limits.maxPushConstantsSize < MATERIAL_INDEX_PUSH_CONSTANT_OFFSET + sizeof(std::uint32_t))
+			return false;
+
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features{};
+		indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		VkPhysicalDeviceFeatures2KHR features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &indexing_features;
+		vkGetPhysicalDeviceFeatures2KHR(m_physical_device, &features);
+		return indexing_features.shaderSampledImageArrayNonUniformIndexing &&
+			indexing_features.descriptorBindingSampledImageUpdateAfterBind &&
+			indexing_features.descriptorBindingUpdateUnusedWhilePending &&
+			indexing_features.descriptorBindingPartiallyBound &&
+			indexing_features.runtimeDescriptorArray;
+	}
+
+	void RenderCore::OpenShaderArchive()
+	{
+		std::filesystem::path directory = ScopEngine::Get().GetAssetsPath() / "Shaders/Build";
+		std::filesystem::path archive_path = directory / "Shaders.pack";
+		p_shader_archive = std::make_unique<ShaderArchive>();
+		if(ShaderArchive::IsOutdated(directory, archive_path))
+			ShaderArchive::Pack(directory, archive_path);
+		if(!p_shader_archive->Open(archive_path))
+			Warning("Renderer: no shader archive available, loading shaders one file at a time");
+	}
+
+	std::shared_ptr<Shader> RenderCore::LoadInternalShader(const std::string& name, ShaderType type) const
+	{
+		if(p_shader_archive->Contains(name))
+			return LoadShaderFromArchive(*p_shader_archive, name, type);
+		return LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build" / (name + ".spv"), type);
+	}
+
 	RenderCore::~RenderCore()
 	{
 		if(s_instance == nullptr)
 			return;
 		WaitDeviceIdle();
+		p_pipeline_compiler->Destroy();
+		p_pipeline_compiler.reset();
+		p_graphic_pipeline_cache->Destroy();
+		p_graphic_pipeline_cache.reset();
 		p_descriptor_pool_manager->Destroy();
 		p_descriptor_pool_manager.reset();
+		p_transient_descriptor_allocator->Destroy();
+		p_transient_descriptor_allocator.reset();
+		p_glyph_cache->Destroy();
+		p_glyph_cache.reset();
+		if(p_bindless_texture_table)
+			p_bindless_texture_table->Destroy();
+		p_bindless_texture_table.reset();
+		m_bindless_enabled = false;
+		p_material_table->Destroy();
+		p_material_table.reset();
+		p_texture_streamer->Destroy();
+		p_texture_streamer.reset();
 		m_allocator.DetachFromDevice();
 		for(auto shader: m_internal_shaders)
 			shader->Destroy();
+		p_descriptor_set_layout_cache->Destroy();
+		p_descriptor_set_layout_cache.reset();
+		p_shader_archive.reset();
+		SavePipelineCache();
+		vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
 		kvfDestroyDevice(m_device);
 		Message("Vulkan: logical device destroyed");
 		kvfDestroyInstance(m_instance);
@@ -2,16 +2,20 @@
 #include <Renderer/Pipelines/Graphics.h>
 #include <Renderer/ViewerData.h>
 #include <Renderer/Renderer.h>
+#include <Renderer/BindlessTextureTable.h>
 #include <Graphics/Scene.h>
 #include <Core/Engine.h>
 #include <Maths/Mat4.h>
 
+#include <algorithm>
+
 namespace Scop
 {
 	struct SpriteData
 	{
 		Mat4f model_matrix;
 		Vec4f color;
+		std::uint32_t texture_index = BINDLESS_INVALID_INDEX; // Only read by the bindless fragment shader
 	};
 
 	struct ViewerData2D
@@ -21,36 +25,24 @@ namespace Scop
 
 	void Render2DPass::Init()
 	{
-		ShaderLayout vertex_shader_layout(
-			{
-				{ 0,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }
-					})
-				}
-			}, { ShaderPushConstantLayout({ 0, sizeof(SpriteData) }) }
-		);
-		p_vertex_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/2DVertex.spv", ShaderType::Vertex, std::move(vertex_shader_layout));
-		ShaderLayout fragment_shader_layout(
-			{
-				{ 1,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER }
-					})
-				}
-			}, {}
-		);
-		p_fragment_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/2DFragment.spv", ShaderType::Fragment, std::move(fragment_shader_layout));
+		p_vertex_shader = RenderCore::Get().LoadInternalShader("2DVertex", ShaderType::Vertex);
+		p_fragment_shader = RenderCore::Get().LoadInternalShader(RenderCore::Get().IsBindlessEnabled() ? "2DFragmentBindless" : "2DFragment", ShaderType::Fragment);
 
 		std::function<void(const EventBase&)> functor = [this](const EventBase& event)
 		{
-			if(event.What() == Event::ResizeEventCode || event.What() == Event::SceneHasChangedEventCode)
+			if(event.What() == Event::ResizeEventCode)
+				m_pipeline.InvalidateFramebuffers();
+			if(event.What() == Event::SceneHasChangedEventCode)
 				m_pipeline.Destroy();
 		};
 		EventBus::RegisterListener({ functor, "__ScopRender2DPass" });
 
 		p_viewer_data_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(p_vertex_shader->GetShaderLayout().set_layouts.at(0), ShaderType::Vertex);
-		p_texture_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(p_fragment_shader->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
+		// The bindless fragment shader samples the texture table, sprites and texts then need no set of their own
+		if(!RenderCore::Get().IsBindlessEnabled())
+			p_texture_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(p_fragment_shader->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
+
+		m_sprite_quads.Init(1024, "scop_2d_sprite_batch");
 
 		p_viewer_data_buffer = std::make_shared<UniformBuffer>();
 		p_viewer_data_buffer->Init(sizeof(ViewerData2D));
@@ -61,19 +53,30 @@ namespace Scop
 		}
 	}
 
+	void Render2DPass::RequestPipeline([[maybe_unused]] Scene& scene, Texture& render_target)
+	{
+		if(m_pipeline.GetPipeline() != VK_NULL_HANDLE || m_pipeline.IsCompiling())
+			return;
+		GraphicPipelineDescriptor pipeline_descriptor;
+		pipeline_descriptor.vertex_shader = p_vertex_shader;
+		pipeline_descriptor.fragment_shader = p_fragment_shader;
+		pipeline_descriptor.color_attachments = { &render_target };
+		pipeline_descriptor.culling = CullMode::None;
+		pipeline_descriptor.clear_color_attachments = false;
+		pipeline_descriptor.name = "2D_pass_pipeline";
+		m_pipeline.Init(std::move(pipeline_descriptor), true);
+	}
+
+	void Render2DPass::Prewarm(Scene& scene, Texture& render_target)
+	{
+		RequestPipeline(scene, render_target);
+	}
+
 	void Render2DPass::Pass(Scene& scene, Renderer& renderer, Texture& render_target)
 	{
-		if(m_pipeline.GetPipeline() == VK_NULL_HANDLE)
-		{
-			GraphicPipelineDescriptor pipeline_descriptor;
-			pipeline_descriptor.vertex_shader = p_vertex_shader;
-			pipeline_descriptor.fragment_shader = p_fragment_shader;
-			pipeline_descriptor.color_attachments = { &render_target };
-			pipeline_descriptor.culling = CullMode::None;
-			pipeline_descriptor.clear_color_attachments = false;
-			pipeline_descriptor.name = "2D_pass_pipeline";
-			m_pipeline.Init(std::move(pipeline_descriptor));
-		}
+		RequestPipeline(scene, render_target);
+		if(!m_pipeline.IsReady())
+			return;
 
 		std::uint32_t frame_index = renderer.GetCurrentFrameIndex();
 
@@ -85,57 +88,173 @@ namespace Scop
 
 		VkCommandBuffer cmd = renderer.GetActiveCommandBuffer();
 		m_pipeline.BindPipeline(cmd, 0, {});
-		for(const auto& [_, sprite] : scene.GetSprites())
+		bool bindless = m_pipeline.UsesBindlessTextures();
+		if(bindless)
 		{
-			SpriteData sprite_data;
-			sprite_data.color = sprite.GetColor();
-
-			Mat4f translation_matrix = Mat4f::Identity().ApplyTranslation(Vec3f{ Vec2f(sprite.GetPosition()), 0.0f });
-			Mat4f scale_matrix = Mat4f::Identity().ApplyScale(Vec3f{ sprite.GetScale(), 1.0f });
+			// Bound once, sprites and texts then only push their texture index
+			VkDescriptorSet viewer_set = p_viewer_data_set->GetSet(frame_index);
+			VkDescriptorSet texture_table_set = RenderCore::Get().GetBindlessTextureTable().GetSet();
+			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, 1, &viewer_set, 0, nullptr);
+			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), BINDLESS_TEXTURE_SET, 1, &texture_table_set, 0, nullptr);
+		}
+		VkShaderStageFlags push_stages = m_pipeline.GetPushConstantStages(0, sizeof(SpriteData));
 
+		BuildSpriteBatches(scene);
+		if(!m_sprite_batches.empty())
+		{
+			// Sprite and glyph quads are already in screen space and carry their color
+			SpriteData sprite_data;
 			sprite_data.model_matrix = Mat4f::Identity();
-			sprite_data.model_matrix.ConcatenateTransform(scale_matrix);
-			sprite_data.model_matrix.ConcatenateTransform(translation_matrix);
-
-			if(!sprite.IsSetInit())
-				const_cast<Sprite&>(sprite).UpdateDescriptorSet(p_texture_set);
-			const_cast<Sprite&>(sprite).Bind(frame_index, cmd);
-			std::array<VkDescriptorSet, 2> sets = { p_viewer_data_set->GetSet(frame_index), sprite.GetSet(frame_index) };
-			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, sets.size(), sets.data(), 0, nullptr);
-			RenderCore::Get().vkCmdPushConstants(cmd, m_pipeline.GetPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(SpriteData), &sprite_data);
-			sprite.GetMesh()->Draw(cmd, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef());
+			sprite_data.color = Vec4f{ 1.0f, 1.0f, 1.0f, 1.0f };
+			if(!bindless)
+				RenderCore::Get().vkCmdPushConstants(cmd, m_pipeline.GetPipelineLayout(), push_stages, 0, sizeof(SpriteData), &sprite_data);
+
+			m_sprite_quads.Flush(frame_index);
+			m_sprite_quads.Bind(cmd, frame_index);
+			for(const SpriteBatch& batch : m_sprite_batches)
+			{
+				VkDescriptorSet texture_set = VK_NULL_HANDLE;
+				if(batch.first != nullptr)
+				{
+					Sprite& sprite = const_cast<Sprite&>(*batch.first);
+					if(!bindless && !sprite.IsSetInit())
+						sprite.UpdateDescriptorSet(p_texture_set);
+					sprite.Bind(frame_index, cmd);
+					if(bindless)
+						sprite_data.texture_index = sprite.GetTexture()->GetBindlessIndex();
+					else
+						texture_set = sprite.GetSet(frame_index);
+				}
+				else
+				{
+					if(bindless)
+						sprite_data.texture_index = RenderCore::Get().GetGlyphCache().GetPageTexture(batch.glyph_page).GetBindlessIndex();
+					else
+					{
+						BindGlyphPage(batch.glyph_page, frame_index, cmd);
+						texture_set = m_glyph_page_sets[batch.glyph_page]->GetSet(frame_index);
+					}
+				}
+				if(bindless)
+				{
+					if(sprite_data.texture_index == BINDLESS_INVALID_INDEX)
+						continue;
+					RenderCore::Get().vkCmdPushConstants(cmd, m_pipeline.GetPipelineLayout(), push_stages, 0, sizeof(SpriteData), &sprite_data);
+				}
+				else
+				{
+					std::array<VkDescriptorSet, 2> sets = { p_viewer_data_set->GetSet(frame_index), texture_set };
+					RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, sets.size(), sets.data(), 0, nullptr);
+				}
+				m_sprite_quads.Draw(cmd, batch.first_quad, batch.quad_count, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef());
+			}
 		}
+		m_pipeline.EndPipeline(cmd);
+	}
+
+	void Render2DPass::BuildSpriteBatches(Scene& scene)
+	{
+		m_sorted_sprites.clear();
+		m_sorted_text_pages.clear();
+		m_sprite_batches.clear();
+		for(const auto& [_, sprite] : scene.GetSprites())
+			m_sorted_sprites.push_back(&sprite);
+		// Draw order between sprites was never defined, grouping them by texture is free
+		std::sort(m_sorted_sprites.begin(), m_sorted_sprites.end(), [](const Sprite* lhs, const Sprite* rhs)
+		{
+			if(lhs->GetTexture() != rhs->GetTexture())
+				return lhs->GetTexture().get() < rhs->GetTexture().get();
+			return lhs->GetUUID() < rhs->GetUUID();
+		});
+
+		// Texts stay above sprites, those sharing a glyph cache page are merged and keep their order otherwise
+		std::uint32_t quad_count = static_cast<std::uint32_t>(m_sorted_sprites.size());
 		for(const auto& [_, text] : scene.GetTexts())
 		{
-			SpriteData sprite_data;
-			sprite_data.color = text.GetColor();
+			const_cast<Text&>(text).Prepare();
+			for(std::size_t page = 0; page < text.GetPageCount(); page++)
+			{
+				m_sorted_text_pages.push_back(TextPage{ &text, page });
+				quad_count += static_cast<std::uint32_t>(text.GetPageQuads(page).size());
+			}
+		}
+		std::stable_sort(m_sorted_text_pages.begin(), m_sorted_text_pages.end(), [](const TextPage& lhs, const TextPage& rhs)
+		{
+			return lhs.text->GetGlyphCachePage(lhs.page) < rhs.text->GetGlyphCachePage(rhs.page);
+		});
 
-			Mat4f translation_matrix = Mat4f::Identity().ApplyTranslation(Vec3f{ Vec2f(text.GetPosition()), 0.0f });
-			Mat4f scale_matrix = Mat4f::Identity().ApplyScale(Vec3f{ text.GetScale(), 1.0f });
+		m_sprite_quads.Resize(quad_count);
+		for(std::uint32_t i = 0; i < m_sorted_sprites.size(); i++)
+		{
+			const Sprite& sprite = *m_sorted_sprites[i];
+			if(m_sprite_batches.empty() || m_sprite_batches.back().first->GetTexture() != sprite.GetTexture())
+				m_sprite_batches.push_back(SpriteBatch{ &sprite, GLYPH_CACHE_NO_PAGE, i, 0 });
+			m_sprite_batches.back().quad_count++;
 
-			sprite_data.model_matrix = Mat4f::Identity();
-			sprite_data.model_matrix.ConcatenateTransform(scale_matrix);
-			sprite_data.model_matrix.ConcatenateTransform(translation_matrix);
-
-			if(!text.IsSetInit())
-				const_cast<Text&>(text).UpdateDescriptorSet(p_texture_set);
-			const_cast<Text&>(text).Bind(frame_index, cmd);
-			std::array<VkDescriptorSet, 2> sets = { p_viewer_data_set->GetSet(frame_index), text.GetSet(frame_index) };
-			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, sets.size(), sets.data(), 0, nullptr);
-			RenderCore::Get().vkCmdPushConstants(cmd, m_pipeline.GetPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(SpriteData), &sprite_data);
-			text.GetMesh()->Draw(cmd, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef());
+			Vec2f position = Vec2f(sprite.GetPosition());
+			Vec2f size = sprite.GetSize() * sprite.GetScale();
+			Vec2f uv_min = sprite.GetUVMin();
+			Vec2f uv_max = sprite.GetUVMax();
+			// The 2D vertex shader negates u, images are stored bottom up
+			Quad quad;
+			quad[0].position = Vec4f{ position.x, position.y, 0.0f, 1.0f };
+			quad[0].uv = Vec2f{ -uv_min.x, uv_max.y };
+			quad[1].position = Vec4f{ position.x + size.x, position.y, 0.0f, 1.0f };
+			quad[1].uv = Vec2f{ -uv_max.x, uv_max.y };
+			quad[2].position = Vec4f{ position.x + size.x, position.y + size.y, 0.0f, 1.0f };
+			quad[2].uv = Vec2f{ -uv_max.x, uv_min.y };
+			quad[3].position = Vec4f{ position.x, position.y + size.y, 0.0f, 1.0f };
+			quad[3].uv = Vec2f{ -uv_min.x, uv_min.y };
+			for(Vertex& vertex : quad)
+				vertex.color = sprite.GetColor();
+			m_sprite_quads.SetQuad(i, quad);
 		}
-		m_pipeline.EndPipeline(cmd);
+
+		std::uint32_t first_quad = static_cast<std::uint32_t>(m_sorted_sprites.size());
+		for(const TextPage& text_page : m_sorted_text_pages)
+		{
+			const Text& text = *text_page.text;
+			std::uint32_t glyph_page = text.GetGlyphCachePage(text_page.page);
+			if(m_sprite_batches.empty() || m_sprite_batches.back().first != nullptr || m_sprite_batches.back().glyph_page != glyph_page)
+				m_sprite_batches.push_back(SpriteBatch{ nullptr, glyph_page, first_quad, 0 });
+
+			// Same transform the text model matrix used to apply, scale then translation
+			Vec2f position = Vec2f(text.GetPosition());
+			Vec2f scale = text.GetScale();
+			for(Quad quad : text.GetPageQuads(text_page.page))
+			{
+				for(Vertex& vertex : quad)
+				{
+					vertex.position.x = vertex.position.x * scale.x + position.x;
+					vertex.position.y = vertex.position.y * scale.y + position.y;
+					vertex.color = text.GetColor();
+				}
+				m_sprite_quads.SetQuad(first_quad++, quad);
+				m_sprite_batches.back().quad_count++;
+			}
+		}
+	}
+
+	void Render2DPass::BindGlyphPage(std::uint32_t glyph_page, std::size_t frame_index, VkCommandBuffer cmd)
+	{
+		std::shared_ptr<DescriptorSet>& set = m_glyph_page_sets[glyph_page];
+		if(!set || !set->IsInit())
+			set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(p_texture_set->GetShaderLayout(), p_texture_set->GetShaderType());
+		set->SetImage(frame_index, 0, RenderCore::Get().GetGlyphCache().GetPageTexture(glyph_page));
+		set->Update(frame_index, cmd);
 	}
 
 	void Render2DPass::Destroy()
 	{
 		RenderCore::Get().WaitDeviceIdle();
 		m_pipeline.Destroy();
+		m_sprite_quads.Destroy();
 		p_vertex_shader.reset();
 		p_fragment_shader.reset();
 		p_viewer_data_set.reset();
 		p_viewer_data_buffer->Destroy();
 		p_texture_set.reset();
+		for(std::shared_ptr<DescriptorSet>& set : m_glyph_page_sets)
+			set.reset();
 	}
 }
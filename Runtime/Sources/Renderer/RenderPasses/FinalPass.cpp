@@ -9,29 +9,17 @@ namespace Scop
 {
 	void FinalPass::Init()
 	{
-		ShaderLayout vertex_shader_layout(
-			{}, {}
-		);
-		p_vertex_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/ScreenVertex.spv", ShaderType::Vertex, std::move(vertex_shader_layout));
-		ShaderLayout fragment_shader_layout(
-			{
-				{ 0,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER }
-					})
-				}
-			}, {}
-		);
-		p_fragment_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/ScreenFragment.spv", ShaderType::Fragment, std::move(fragment_shader_layout));
+		p_vertex_shader = RenderCore::Get().LoadInternalShader("ScreenVertex", ShaderType::Vertex);
+		p_fragment_shader = RenderCore::Get().LoadInternalShader("ScreenFragment", ShaderType::Fragment);
 
 		std::function<void(const EventBase&)> functor = [this](const EventBase& event)
 		{
 			if(event.What() == Event::ResizeEventCode)
-				m_pipeline.Destroy();
+				m_pipeline.InvalidateFramebuffers();
 		};
 		EventBus::RegisterListener({ functor, "__ScopFinalPass" });
 
-		p_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(p_fragment_shader->GetShaderLayout().set_layouts.at(0), ShaderType::Fragment);
+		m_set.Init(p_fragment_shader->GetShaderLayout().set_layouts.at(0), ShaderType::Fragment);
 	}
 
 	void FinalPass::Pass(Scene& scene, Renderer& renderer, Texture& render_target)
@@ -50,11 +38,11 @@ namespace Scop
 
 		VkCommandBuffer cmd = renderer.GetActiveCommandBuffer();
 
-		p_set->SetImage(renderer.GetCurrentFrameIndex(), 0, render_target);
-		p_set->Update(renderer.GetCurrentFrameIndex(), cmd);
+		m_set.SetImage(0, render_target);
+		m_set.Update(renderer.GetCurrentFrameIndex(), cmd);
 
 		m_pipeline.BindPipeline(cmd, renderer.GetSwapchain().GetImageIndex(), { 0.0f, 0.0f, 0.0f, 1.0f });
-			VkDescriptorSet set = p_set->GetSet(renderer.GetCurrentFrameIndex());
+			VkDescriptorSet set = m_set.GetSet(renderer.GetCurrentFrameIndex());
 			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, 1, &set, 0, nullptr);
 			RenderCore::Get().vkCmdDraw(cmd, 3, 1, 0, 0);
 			renderer.GetDrawCallsCounterRef()++;
@@ -68,6 +56,5 @@ namespace Scop
 		m_pipeline.Destroy();
 		p_vertex_shader.reset();
 		p_fragment_shader.reset();
-		p_set.reset();
 	}
 }
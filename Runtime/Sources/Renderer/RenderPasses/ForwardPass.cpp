@@ -1,6 +1,8 @@
 #include <Renderer/RenderPasses/ForwardPass.h>
 #include <Renderer/Pipelines/Graphics.h>
+#include <Renderer/Pipelines/PipelineCache.h>
 #include <Renderer/ViewerData.h>
+#include <Renderer/MaterialTable.h>
 #include <Renderer/Renderer.h>
 #include <Graphics/Scene.h>
 #include <Maths/Mat4.h>
@@ -15,40 +17,81 @@ namespace Scop
 		Mat4f normal_mat;
 	};
 
+	void ForwardPass::RequestScenePipeline(Scene& scene, Texture& render_target)
+	{
+		if(scene.GetPipeline().GetPipeline() != VK_NULL_HANDLE || scene.GetPipeline().IsCompiling())
+			return;
+		GraphicPipelineDescriptor pipeline_descriptor;
+		pipeline_descriptor.vertex_shader = RenderCore::Get().GetDefaultVertexShader();
+		pipeline_descriptor.fragment_shader = scene.GetFragmentShader();
+		pipeline_descriptor.color_attachments = { &render_target };
+		pipeline_descriptor.depth = &scene.GetDepth();
+		pipeline_descriptor.clear_color_attachments = false;
+		pipeline_descriptor.name = "forward_pass_pipeline";
+		scene.GetPipeline().Init(std::move(pipeline_descriptor), true);
+	}
+
+	void ForwardPass::RequestActorPipeline(Scene& scene, Actor& actor, Texture& render_target)
+	{
+		std::shared_ptr<GraphicPipeline> custom_pipeline = actor.GetCustomPipeline()->pipeline;
+		if(!custom_pipeline)
+			return;
+		if((custom_pipeline->GetPipeline() != VK_NULL_HANDLE || custom_pipeline->IsCompiling()) && custom_pipeline->GetDescription().depth.Get() == &scene.GetDepth())
+			return;
+		// Actors sharing the same custom description end up sharing the same pipeline
+		GraphicPipelineDescriptor descriptor = custom_pipeline->GetDescription();
+		descriptor.color_attachments = { &render_target };
+		descriptor.depth = &scene.GetDepth();
+		descriptor.renderer = nullptr;
+		descriptor.clear_color_attachments = false;
+		actor.GetCustomPipeline()->pipeline = RenderCore::Get().GetGraphicPipelineCache().RequestPipeline(std::move(descriptor), true);
+	}
+
+	void ForwardPass::Prewarm(Scene& scene, Texture& render_target)
+	{
+		RequestScenePipeline(scene, render_target);
+		for(auto& [_, actor] : scene.GetActors())
+		{
+			if(actor.GetCustomPipeline().has_value())
+				RequestActorPipeline(scene, const_cast<Actor&>(actor), render_target);
+		}
+	}
+
 	void ForwardPass::Pass(Scene& scene, Renderer& renderer, class Texture& render_target)
 	{
+		RequestScenePipeline(scene, render_target);
+		// Nothing to draw with until the default forward pipeline is compiled
+		if(!scene.GetPipeline().IsReady())
+			return;
 		NonOwningPtr<GraphicPipeline> pipeline = &scene.GetPipeline();
-		if(scene.GetPipeline().GetPipeline() == VK_NULL_HANDLE)
+
+		if(scene.GetForwardData().material_table_set)
 		{
-			GraphicPipelineDescriptor pipeline_descriptor;
-			pipeline_descriptor.vertex_shader = RenderCore::Get().GetDefaultVertexShader();
-			pipeline_descriptor.fragment_shader = scene.GetFragmentShader();
-			pipeline_descriptor.color_attachments = { &render_target };
-			pipeline_descriptor.depth = &scene.GetDepth();
-			pipeline_descriptor.clear_color_attachments = false;
-			pipeline_descriptor.name = "forward_pass_pipeline";
-			scene.GetPipeline().Init(std::move(pipeline_descriptor));
+			// The table buffer is recreated when it grows, the descriptor is only written again when it changed
+			MaterialTable& table = RenderCore::Get().GetMaterialTable();
+			std::size_t frame_index = renderer.GetCurrentFrameIndex();
+			scene.GetForwardData().material_table_set->SetStorageBuffer(frame_index, 0, table.GetBuffer(), table.GetFrameRegionOffset(frame_index), table.GetFrameRegionSize());
+			scene.GetForwardData().material_table_set->Update(frame_index, renderer.GetActiveCommandBuffer());
 		}
 
-		auto render_actor = [&render_target, &renderer, &scene, &pipeline](Actor& actor)
+		auto render_actor = [this, &render_target, &renderer, &scene, &pipeline](Actor& actor)
 		{
 			Scene::ForwardData& data = scene.GetForwardData();
 			VkCommandBuffer cmd = renderer.GetActiveCommandBuffer();
-			std::shared_ptr<GraphicPipeline> custom_pipeline = (actor.GetCustomPipeline().has_value() ? actor.GetCustomPipeline()->pipeline : nullptr);
+			std::shared_ptr<GraphicPipeline> custom_pipeline;
+			if(actor.GetCustomPipeline().has_value())
+			{
+				this->RequestActorPipeline(scene, actor, render_target);
+				custom_pipeline = actor.GetCustomPipeline()->pipeline;
+				// Falls back to the scene pipeline while the custom one is still compiling
+				if(custom_pipeline && !custom_pipeline->IsReady())
+					custom_pipeline = nullptr;
+			}
 
 			if(custom_pipeline && !custom_pipeline->IsPipelineBound())
 			{
 				pipeline->EndPipeline(cmd);
-				pipeline = actor.GetCustomPipeline()->pipeline.get();
-				if(pipeline->GetDescription().depth != NonOwningPtr<DepthImage>{ &scene.GetDepth() })
-				{
-					GraphicPipelineDescriptor descriptor = pipeline->GetDescription();
-					descriptor.color_attachments = { &render_target };
-					descriptor.depth = &scene.GetDepth();
-					descriptor.renderer = nullptr;
-					descriptor.clear_color_attachments = false;
-					pipeline->Init(std::move(descriptor));
-				}
+				pipeline = custom_pipeline.get();
 				pipeline->BindPipeline(cmd, 0, {});
 			}
 			else if(!custom_pipeline && !scene.GetPipeline().IsPipelineBound())
@@ -66,7 +109,11 @@ namespace Scop
 			model_data.normal_mat = model_data.model_mat;
 			model_data.normal_mat.Inverse().Transpose();
 
-			RenderCore::Get().vkCmdPushConstants(cmd, pipeline->GetPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ModelData), &model_data);
+			// Bindless fragment shaders read the same push constant block for their material index
+			VkShaderStageFlags push_stages = pipeline->GetPushConstantStages(0, sizeof(ModelData));
+			if(push_stages != 0)
+				RenderCore::Get().vkCmdPushConstants(cmd, pipeline->GetPipelineLayout(), push_stages, 0, sizeof(ModelData), &model_data);
+			std::shared_ptr<DescriptorSet> material_set = (pipeline->UsesBindlessTextures() ? data.material_table_set : data.albedo_set);
 
 			if(custom_pipeline)
 			{
@@ -87,10 +134,10 @@ namespace Scop
 						actor.GetCustomPipeline()->set->Update(i);
 					}
 				}
-				actor.GetModel().Draw(cmd, actor.GetCustomPipeline()->set, *pipeline, data.albedo_set, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef(), renderer.GetCurrentFrameIndex());
+				actor.GetModel().Draw(cmd, actor.GetCustomPipeline()->set, *pipeline, material_set, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef(), renderer.GetCurrentFrameIndex());
 			}
 			else
-				actor.GetModel().Draw(cmd, data.matrices_set, *pipeline, data.albedo_set, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef(), renderer.GetCurrentFrameIndex());
+				actor.GetModel().Draw(cmd, data.matrices_set, *pipeline, material_set, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef(), renderer.GetCurrentFrameIndex());
 		};
 
 		std::multimap<float, Actor&> sorted_actors;
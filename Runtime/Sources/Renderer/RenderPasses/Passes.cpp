@@ -10,22 +10,33 @@ namespace Scop
 		m_2Dpass.Init();
 		m_post_process.Init();
 		m_final.Init();
+	}
 
-		std::function<void(const EventBase&)> functor = [this](const EventBase& event)
-		{
-			if(event.What() == Event::ResizeEventCode)
-				m_main_render_texture.Destroy();
-		};
-		EventBus::RegisterListener({ functor, "__ScopRenderPasses" });
+	void RenderPasses::CreateMainRenderTexture(Renderer& renderer)
+	{
+		// Kept as long as the swapchain size does not change, recreated with the same format otherwise so pipelines using it survive
+		auto extent = kvfGetSwapchainImagesSize(renderer.GetSwapchain().Get());
+		if(m_main_render_texture.IsInit() && m_main_render_texture.GetWidth() == extent.width && m_main_render_texture.GetHeight() == extent.height)
+			return;
+		m_main_render_texture.Destroy();
+		m_main_render_texture.Init({}, extent.width, extent.height, VK_FORMAT_R8G8B8A8_UNORM, false, "scop_main_render_texture", false);
+	}
+
+	void RenderPasses::Prewarm(Scene& scene, Renderer& renderer)
+	{
+		CreateMainRenderTexture(renderer);
+		if(scene.GetDescription().render_3D_enabled)
+			m_forward.Prewarm(scene, m_main_render_texture);
+		if(scene.GetDescription().render_skybox_enabled)
+			m_skybox.Prewarm(scene, m_main_render_texture);
+		// The post process target only exists once its pass ran, the 2D pipeline is then left to the first frame
+		if(scene.GetDescription().render_2D_enabled && !(scene.GetDescription().render_post_process_enabled && scene.GetDescription().post_process_shader))
+			m_2Dpass.Prewarm(scene, m_main_render_texture);
 	}
 
 	void RenderPasses::Pass(Scene& scene, Renderer& renderer)
 	{
-		if(!m_main_render_texture.IsInit())
-		{
-			auto extent = kvfGetSwapchainImagesSize(renderer.GetSwapchain().Get());
-			m_main_render_texture.Init({}, extent.width, extent.height, VK_FORMAT_R8G8B8A8_UNORM, false, "scop_main_render_texture", false);
-		}
+		CreateMainRenderTexture(renderer);
 
 		scene.GetDepth().Clear(renderer.GetActiveCommandBuffer(), {});
 		m_main_render_texture.Clear(renderer.GetActiveCommandBuffer(), Vec4f{ 0.0f, 0.0f, 0.0f, 1.0f });
@@ -9,18 +9,12 @@ namespace Scop
 {
 	void PostProcessPass::Init()
 	{
-		ShaderLayout vertex_shader_layout(
-			{}, {}
-		);
-		p_vertex_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/ScreenVertex.spv", ShaderType::Vertex, std::move(vertex_shader_layout));
+		p_vertex_shader = RenderCore::Get().LoadInternalShader("ScreenVertex", ShaderType::Vertex);
 
 		std::function<void(const EventBase&)> functor = [this](const EventBase& event)
 		{
 			if(event.What() == Event::ResizeEventCode)
-			{
-				m_render_texture.Destroy();
-				m_pipeline.Destroy();
-			}
+				m_pipeline.InvalidateFramebuffers();
 		};
 		EventBus::RegisterListener({ functor, "__ScopPostProcessPass" });
 	}
@@ -29,9 +23,11 @@ namespace Scop
 	{
 		Scene::PostProcessData& data = scene.GetPostProcessData();
 
-		if(!m_render_texture.IsInit())
+		auto extent = kvfGetSwapchainImagesSize(renderer.GetSwapchain().Get());
+		if(!m_render_texture.IsInit() || m_render_texture.GetWidth() != extent.width || m_render_texture.GetHeight() != extent.height)
 		{
-			auto extent = kvfGetSwapchainImagesSize(renderer.GetSwapchain().Get());
+			// Recreated at the new size with the same format, the pipeline only needs new framebuffers
+			m_render_texture.Destroy();
 			m_render_texture.Init({}, extent.width, extent.height, VK_FORMAT_R8G8B8A8_UNORM, false, "scop_post_process_render_texture", false);
 		}
 
@@ -50,13 +46,13 @@ namespace Scop
 
 		VkCommandBuffer cmd = renderer.GetActiveCommandBuffer();
 
-		data.set->SetImage(renderer.GetCurrentFrameIndex(), 0, render_target);
-		data.set->SetImage(renderer.GetCurrentFrameIndex(), 1, scene.GetDepth());
-		data.set->SetUniformBuffer(renderer.GetCurrentFrameIndex(), 2, data.data_buffer->Get(renderer.GetCurrentFrameIndex()));
-		data.set->Update(renderer.GetCurrentFrameIndex(), cmd);
+		data.set.SetImage(0, render_target);
+		data.set.SetImage(1, scene.GetDepth());
+		data.set.SetUniformBuffer(2, data.data_buffer->Get(renderer.GetCurrentFrameIndex()));
+		data.set.Update(renderer.GetCurrentFrameIndex(), cmd);
 
 		m_pipeline.BindPipeline(cmd, 0, {});
-			VkDescriptorSet set = data.set->GetSet(renderer.GetCurrentFrameIndex());
+			VkDescriptorSet set = data.set.GetSet(renderer.GetCurrentFrameIndex());
 			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, 1, &set, 0, nullptr);
 			RenderCore::Get().vkCmdDraw(cmd, 3, 1, 0, 0);
 			renderer.GetDrawCallsCounterRef()++;
@@ -11,36 +11,42 @@ namespace Scop
 {
 	void SkyboxPass::Init()
 	{
-		ShaderLayout vertex_shader_layout(
-			{
-				{ 0,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }
-					})
-				}
-			}, {}
-		);
-		p_vertex_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/SkyboxVertex.spv", ShaderType::Vertex, std::move(vertex_shader_layout));
-		ShaderLayout fragment_shader_layout(
-			{
-				{ 1,
-					ShaderSetLayout({ 
-						{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER }
-					})
-				}
-			}, {}
-		);
-		p_fragment_shader = LoadShaderFromFile(ScopEngine::Get().GetAssetsPath() / "Shaders/Build/SkyboxFragment.spv", ShaderType::Fragment, std::move(fragment_shader_layout));
+		p_vertex_shader = RenderCore::Get().LoadInternalShader("SkyboxVertex", ShaderType::Vertex);
+		p_fragment_shader = RenderCore::Get().LoadInternalShader("SkyboxFragment", ShaderType::Fragment);
 
 		std::function<void(const EventBase&)> functor = [this](const EventBase& event)
 		{
-			if(event.What() == Event::ResizeEventCode || event.What() == Event::SceneHasChangedEventCode)
+			if(event.What() == Event::ResizeEventCode)
+				m_pipeline.InvalidateFramebuffers();
+			if(event.What() == Event::SceneHasChangedEventCode)
 				m_pipeline.Destroy();
 		};
 		EventBus::RegisterListener({ functor, "__ScopSkyboxPass" });
 
 		m_cube = CreateCube();
-		p_set = RenderCore::Get().GetDescriptorPoolManager().GetAvailablePool().RequestDescriptorSet(p_fragment_shader->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
+		m_set.Init(p_fragment_shader->GetShaderLayout().set_layouts.at(1), ShaderType::Fragment);
+	}
+
+	void SkyboxPass::RequestPipeline(Scene& scene, Texture& render_target)
+	{
+		if(m_pipeline.GetPipeline() != VK_NULL_HANDLE || m_pipeline.IsCompiling())
+			return;
+		GraphicPipelineDescriptor pipeline_descriptor;
+		pipeline_descriptor.vertex_shader = p_vertex_shader;
+		pipeline_descriptor.fragment_shader = p_fragment_shader;
+		pipeline_descriptor.color_attachments = { &render_target };
+		pipeline_descriptor.depth = &scene.GetDepth();
+		pipeline_descriptor.culling = CullMode::None;
+		pipeline_descriptor.depth_test_equal = true;
+		pipeline_descriptor.clear_color_attachments = false;
+		pipeline_descriptor.name = "skybox_pass_pipeline";
+		m_pipeline.Init(std::move(pipeline_descriptor), true);
+	}
+
+	void SkyboxPass::Prewarm(Scene& scene, Texture& render_target)
+	{
+		if(scene.GetSkybox())
+			RequestPipeline(scene, render_target);
 	}
 
 	void SkyboxPass::Pass(Scene& scene, Renderer& renderer, class Texture& render_target)
@@ -48,27 +54,17 @@ namespace Scop
 		if(!scene.GetSkybox())
 			return;
 
-		if(m_pipeline.GetPipeline() == VK_NULL_HANDLE)
-		{
-			GraphicPipelineDescriptor pipeline_descriptor;
-			pipeline_descriptor.vertex_shader = p_vertex_shader;
-			pipeline_descriptor.fragment_shader = p_fragment_shader;
-			pipeline_descriptor.color_attachments = { &render_target };
-			pipeline_descriptor.depth = &scene.GetDepth();
-			pipeline_descriptor.culling = CullMode::None;
-			pipeline_descriptor.depth_test_equal = true;
-			pipeline_descriptor.clear_color_attachments = false;
-			pipeline_descriptor.name = "skybox_pass_pipeline";
-			m_pipeline.Init(std::move(pipeline_descriptor));
-		}
+		RequestPipeline(scene, render_target);
+		if(!m_pipeline.IsReady())
+			return;
 
 		VkCommandBuffer cmd = renderer.GetActiveCommandBuffer();
 
-		p_set->SetImage(renderer.GetCurrentFrameIndex(), 0, *scene.GetSkybox());
-		p_set->Update(renderer.GetCurrentFrameIndex(), cmd);
+		m_set.SetImage(0, *scene.GetSkybox());
+		m_set.Update(renderer.GetCurrentFrameIndex(), cmd);
 
 		m_pipeline.BindPipeline(cmd, 0, {});
-			std::array<VkDescriptorSet, 2> sets = { scene.GetForwardData().matrices_set->GetSet(renderer.GetCurrentFrameIndex()), p_set->GetSet(renderer.GetCurrentFrameIndex()) };
+			std::array<VkDescriptorSet, 2> sets = { scene.GetForwardData().matrices_set->GetSet(renderer.GetCurrentFrameIndex()), m_set.GetSet(renderer.GetCurrentFrameIndex()) };
 			RenderCore::Get().vkCmdBindDescriptorSets(cmd, m_pipeline.GetPipelineBindPoint(), m_pipeline.GetPipelineLayout(), 0, sets.size(), sets.data(), 0, nullptr);
 			m_cube->Draw(cmd, renderer.GetDrawCallsCounterRef(), renderer.GetPolygonDrawnCounterRef());
 		m_pipeline.EndPipeline(cmd);
@@ -81,6 +77,5 @@ namespace Scop
 		p_vertex_shader.reset();
 		p_fragment_shader.reset();
 		m_cube.reset();
-		p_set.reset();
 	}
 }
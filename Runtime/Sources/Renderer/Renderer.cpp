@@ -1,4 +1,8 @@
 #include <Renderer/Renderer.h>
+#include <Renderer/BindlessTextureTable.h>
+#include <Renderer/Descriptor.h>
+#include <Renderer/TextureStreamer.h>
+#include <Graphics/GlyphCache.h>
 #include <Core/Logs.h>
 #include <Core/Enums.h>
 #include <Core/Engine.h>
@@ -18,7 +22,8 @@ namespace Scop
 	{
 		std::function<void(const EventBase&)> functor = [this](const EventBase& event)
 		{
-			if(event.What() == Event::ResizeEventCode)
+			// Render finished semaphores are per swapchain image, they only need to follow the images count
+			if(event.What() == Event::ResizeEventCode && m_render_finished_semaphores.size() != m_swapchain.GetImagesCount())
 			{
 				for(std::size_t i = 0; i < m_render_finished_semaphores.size(); i++)
 				{
@@ -56,9 +61,15 @@ namespace Scop
 	void Renderer::BeginFrame()
 	{
 		kvfWaitForFence(RenderCore::Get().GetDevice(), m_cmd_fences[m_current_frame_index]);
+		RenderCore::Get().GetTransientDescriptorAllocator().Reset(m_current_frame_index);
+		if(RenderCore::Get().IsBindlessEnabled())
+			RenderCore::Get().GetBindlessTextureTable().Update();
+		RenderCore::Get().GetGlyphCache().Update();
 		m_swapchain.AquireFrame(m_image_available_semaphores[m_current_frame_index]);
 		RenderCore::Get().vkResetCommandBuffer(m_cmd_buffers[m_current_frame_index], 0);
 		kvfBeginCommandBuffer(m_cmd_buffers[m_current_frame_index], 0);
+		// Recorded before any pass so the new mips are ready when they are sampled
+		RenderCore::Get().GetTextureStreamer().Update(m_cmd_buffers[m_current_frame_index]);
 		m_drawcalls = 0;
 		m_polygons_drawn = 0;
 		EventBus::SendBroadcast(Internal::FrameBeginEventBroadcast{});
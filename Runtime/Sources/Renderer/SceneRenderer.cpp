@@ -12,6 +12,11 @@ namespace Scop
 		m_passes.Init();
 	}
 
+	void SceneRenderer::Prewarm(Scene& scene, Renderer& renderer)
+	{
+		m_passes.Prewarm(scene, renderer);
+	}
+
 	void SceneRenderer::Render(Scene& scene, Renderer& renderer)
 	{
 		if(scene.GetCamera())
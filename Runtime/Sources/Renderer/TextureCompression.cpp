@@ -0,0 +1,405 @@
+#include <cmath>
+#include <cstring>
+
+#include <Renderer/TextureCompression.h>
+#include <Core/Logs.h>
+
+namespace Scop
+{
+	namespace Internal
+	{
+		struct TexelBlock
+		{
+			float texels[16][4];
+		};
+
+		// Edge blocks repeat the last row and column
+		void FetchBlock(const std::uint8_t* pixels, std::uint32_t width, std::uint32_t height, std::uint32_t block_x, std::uint32_t block_y, TexelBlock& block) noexcept
+		{
+			for(std::uint32_t i = 0; i < 16; i++)
+			{
+				std::uint32_t x = std::min(block_x * 4 + i % 4, width - 1);
+				std::uint32_t y = std::min(block_y * 4 + i / 4, height - 1);
+				for(std::uint32_t c = 0; c < 4; c++)
+					block.texels[i][c] = pixels[(y * width + x) * 4 + c];
+			}
+		}
+
+		// Endpoints are the extremes of the block projected on its principal axis
+		void FitEndpoints(const TexelBlock& block, std::uint32_t channels, float (&low)[4], float (&high)[4]) noexcept
+		{
+			float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float min[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+			float max[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for(std::uint32_t i = 0; i < 16; i++)
+			{
+				for(std::uint32_t c = 0; c < channels; c++)
+				{
+					mean[c] += block.texels[i][c] / 16.0f;
+					min[c] = std::min(min[c], block.texels[i][c]);
+					max[c] = std::max(max[c], block.texels[i][c]);
+				}
+			}
+
+			float covariance[4][4] = {};
+			for(std::uint32_t i = 0; i < 16; i++)
+			{
+				for(std::uint32_t a = 0; a < channels; a++)
+					for(std::uint32_t b = 0; b < channels; b++)
+						covariance[a][b] += (block.texels[i][a] - mean[a]) * (block.texels[i][b] - mean[b]);
+			}
+
+			float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for(std::uint32_t c = 0; c < channels; c++)
+				axis[c] = max[c] - min[c];
+			for(std::uint32_t iteration = 0; iteration < 8; iteration++)
+			{
+				float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				float length = 0.0f;
+				for(std::uint32_t a = 0; a < channels; a++)
+				{
+					for(std::uint32_t b = 0; b < channels; b++)
+						next[a] += covariance[a][b] * axis[b];
+					length = std::max(length, std::abs(next[a]));
+				}
+				if(length < 1e-6f)
+					break;
+				for(std::uint32_t c = 0; c < channels; c++)
+					axis[c] = next[c] / length;
+			}
+
+			float length = 0.0f;
+			for(std::uint32_t c = 0; c < channels; c++)
+				length += axis[c] * axis[c];
+			if(length < 1e-6f)
+			{
+				// Flat block
+				for(std::uint32_t c = 0; c < 4; c++)
+					low[c] = high[c] = (c < channels ? mean[c] : 255.0f);
+				return;
+			}
+			length = std::sqrt(length);
+			for(std::uint32_t c = 0; c < channels; c++)
+				axis[c] /= length;
+
+			float min_projection = 0.0f;
+			float max_projection = 0.0f;
+			for(std::uint32_t i = 0; i < 16; i++)
+			{
+				float projection = 0.0f;
+				for(std::uint32_t c = 0; c < channels; c++)
+					projection += (block.texels[i][c] - mean[c]) * axis[c];
+				min_projection = std::min(min_projection, projection);
+				max_projection = std::max(max_projection, projection);
+			}
+			for(std::uint32_t c = 0; c < 4; c++)
+			{
+				low[c] = (c < channels ? std::clamp(mean[c] + axis[c] * min_projection, 0.0f, 255.0f) : 255.0f);
+				high[c] = (c < channels ? std::clamp(mean[c] + axis[c] * max_projection, 0.0f, 255.0f) : 255.0f);
+			}
+		}
+
+		template<std::size_t N>
+		std::uint32_t FindClosest(const float* texel, const float (&palette)[N][4], std::uint32_t channels) noexcept
+		{
+			std::uint32_t best = 0;
+			float best_error = 0.0f;
+			for(std::uint32_t i = 0; i < N; i++)
+			{
+				float error = 0.0f;
+				for(std::uint32_t c = 0; c < channels; c++)
+					error += (texel[c] - palette[i][c]) * (texel[c] - palette[i][c]);
+				if(i == 0 || error < best_error)
+				{
+					best = i;
+					best_error = error;
+				}
+			}
+			return best;
+		}
+
+		std::uint16_t PackRGB565(const float (&color)[4]) noexcept
+		{
+			std::uint32_t r = static_cast<std::uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+			std::uint32_t g = static_cast<std::uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+			std::uint32_t b = static_cast<std::uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+			return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		void UnpackRGB565(std::uint16_t packed, float (&color)[4]) noexcept
+		{
+			std::uint32_t r = (packed >> 11) & 0x1F;
+			std::uint32_t g = (packed >> 5) & 0x3F;
+			std::uint32_t b = packed & 0x1F;
+			color[0] = static_cast<float>((r << 3) | (r >> 2));
+			color[1] = static_cast<float>((g << 2) | (g >> 4));
+			color[2] = static_cast<float>((b << 3) | (b >> 2));
+			color[3] = 255.0f;
+		}
+
+		// Always uses the four colors mode, BC1 punch-through alpha is not supported
+		void EncodeColorBlock(const TexelBlock& block, std::uint8_t* dst) noexcept
+		{
+			float low[4];
+			float high[4];
+			FitEndpoints(block, 3, low, high);
+			std::uint16_t color0 = PackRGB565(high);
+			std::uint16_t color1 = PackRGB565(low);
+			if(color0 < color1)
+				std::swap(color0, color1);
+
+			std::uint32_t indices = 0;
+			if(color0 != color1)
+			{
+				float palette[4][4];
+				UnpackRGB565(color0, palette[0]);
+				UnpackRGB565(color1, palette[1]);
+				for(std::uint32_t c = 0; c < 3; c++)
+				{
+					palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+					palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+				}
+				for(std::uint32_t i = 0; i < 16; i++)
+					indices |= FindClosest(block.texels[i], palette, 3) << (i * 2);
+			}
+			dst[0] = color0 & 0xFF;
+			dst[1] = color0 >> 8;
+			dst[2] = color1 & 0xFF;
+			dst[3] = color1 >> 8;
+			for(std::uint32_t i = 0; i < 4; i++)
+				dst[4 + i] = (indices >> (i * 8)) & 0xFF;
+		}
+
+		void EncodeAlphaBlock(const TexelBlock& block, std::uint8_t* dst) noexcept
+		{
+			float min = 255.0f;
+			float max = 0.0f;
+			for(std::uint32_t i = 0; i < 16; i++)
+			{
+				min = std::min(min, block.texels[i][3]);
+				max = std::max(max, block.texels[i][3]);
+			}
+			std::uint8_t alpha0 = static_cast<std::uint8_t>(std::lround(max));
+			std::uint8_t alpha1 = static_cast<std::uint8_t>(std::lround(min));
+
+			std::uint64_t indices = 0;
+			if(alpha0 != alpha1) // Equal alphas decode as alpha0 with zeroed indices
+			{
+				float palette[8][4] = {};
+				palette[0][0] = alpha0;
+				palette[1][0] = alpha1;
+				for(std::uint32_t i = 2; i < 8; i++)
+					palette[i][0] = ((8.0f - i) * alpha0 + (i - 1.0f) * alpha1) / 7.0f;
+				for(std::uint32_t i = 0; i < 16; i++)
+				{
+					float alpha = block.texels[i][3];
+					indices |= static_cast<std::uint64_t>(FindClosest(&alpha, palette, 1)) << (i * 3);
+				}
+			}
+			dst[0] = alpha0;
+			dst[1] = alpha1;
+			for(std::uint32_t i = 0; i < 6; i++)
+				dst[2 + i] = (indices >> (i * 8)) & 0xFF;
+		}
+
+		class BitWriter
+		{
+			public:
+				BitWriter(std::uint8_t* data) : p_data(data) {}
+
+				void Write(std::uint32_t value, std::uint32_t count) noexcept
+				{
+					for(std::uint32_t i = 0; i < count; i++, m_position++)
+					{
+						if((value >> i) & 1)
+							p_data[m_position / 8] |= static_cast<std::uint8_t>(1u << (m_position % 8));
+					}
+				}
+
+			private:
+				std::uint8_t* p_data;
+				std::uint32_t m_position = 0;
+		};
+
+		// Seven bits per channel plus a p-bit shared by the four channels of the endpoint
+		void QuantizeBC7Endpoint(const float (&color)[4], std::uint32_t (&quantized)[4], std::uint32_t& p_bit) noexcept
+		{
+			float best_error = 0.0f;
+			for(std::uint32_t p = 0; p < 2; p++)
+			{
+				std::uint32_t candidate[4];
+				float error = 0.0f;
+				for(std::uint32_t c = 0; c < 4; c++)
+				{
+					candidate[c] = static_cast<std::uint32_t>(std::clamp(std::lround((color[c] - p) / 2.0f), 0l, 127l));
+					float reconstructed = static_cast<float>((candidate[c] << 1) | p);
+					error += (reconstructed - color[c]) * (reconstructed - color[c]);
+				}
+				if(p == 0 || error < best_error)
+				{
+					best_error = error;
+					p_bit = p;
+					std::copy(std::begin(candidate), std::end(candidate), std::begin(quantized));
+				}
+			}
+		}
+
+		void EncodeBC7Block(const TexelBlock& block, std::uint8_t* dst) noexcept
+		{
+			constexpr std::uint32_t weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+			float low[4];
+			float high[4];
+			FitEndpoints(block, 4, low, high);
+			std::uint32_t endpoints[2][4];
+			std::uint32_t p_bits[2];
+			QuantizeBC7Endpoint(low, endpoints[0], p_bits[0]);
+			QuantizeBC7Endpoint(high, endpoints[1], p_bits[1]);
+
+			float palette[16][4];
+			for(std::uint32_t c = 0; c < 4; c++)
+			{
+				std::uint32_t e0 = (endpoints[0][c] << 1) | p_bits[0];
+				std::uint32_t e1 = (endpoints[1][c] << 1) | p_bits[1];
+				for(std::uint32_t i = 0; i < 16; i++)
+					palette[i][c] = static_cast<float>(((64 - weights[i]) * e0 + weights[i] * e1 + 32) >> 6);
+			}
+			std::uint32_t indices[16];
+			for(std::uint32_t i = 0; i < 16; i++)
+				indices[i] = FindClosest(block.texels[i], palette, 4);
+
+			// The anchor index is stored without its high bit
+			if(indices[0] & 0x8)
+			{
+				std::swap(endpoints[0], endpoints[1]);
+				std::swap(p_bits[0], p_bits[1]);
+				for(std::uint32_t& index : indices)
+					index = 15 - index;
+			}
+
+			std::memset(dst, 0, 16);
+			BitWriter writer(dst);
+			writer.Write(1u << 6, 7); // Mode 6
+			for(std::uint32_t c = 0; c < 4; c++)
+			{
+				writer.Write(endpoints[0][c], 7);
+				writer.Write(endpoints[1][c], 7);
+			}
+			writer.Write(p_bits[0], 1);
+			writer.Write(p_bits[1], 1);
+			writer.Write(indices[0], 3);
+			for(std::uint32_t i = 1; i < 16; i++)
+				writer.Write(indices[i], 4);
+		}
+	}
+
+	std::vector<CPUBuffer> GenerateMipChain(const CPUBuffer& pixels, std::uint32_t width, std::uint32_t height)
+	{
+		std::vector<CPUBuffer> chain;
+		chain.reserve(ComputeMipLevelsCount(width, height));
+		chain.push_back(pixels.Duplicate());
+		while(width > 1 || height > 1)
+		{
+			std::uint32_t next_width = std::max(width / 2, 1u);
+			std::uint32_t next_height = std::max(height / 2, 1u);
+			CPUBuffer level(next_width * next_height * 4);
+			const std::uint8_t* src = chain.back().GetData();
+			std::uint8_t* dst = level.GetData();
+			for(std::uint32_t y = 0; y < next_height; y++)
+			{
+				std::uint32_t y0 = std::min(y * 2, height - 1);
+				std::uint32_t y1 = std::min(y * 2 + 1, height - 1);
+				for(std::uint32_t x = 0; x < next_width; x++)
+				{
+					std::uint32_t x0 = std::min(x * 2, width - 1);
+					std::uint32_t x1 = std::min(x * 2 + 1, width - 1);
+					for(std::uint32_t c = 0; c < 4; c++)
+					{
+						std::uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] + src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+						dst[(y * next_width + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+			chain.push_back(std::move(level));
+			width = next_width;
+			height = next_height;
+		}
+		return chain;
+	}
+
+	std::uint32_t GetFormatBlockSize(VkFormat format) noexcept
+	{
+		switch(format)
+		{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+			case VK_FORMAT_BC4_SNORM_BLOCK: return 8;
+
+			case VK_FORMAT_BC2_UNORM_BLOCK:
+			case VK_FORMAT_BC2_SRGB_BLOCK:
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC5_SNORM_BLOCK:
+			case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+			case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK: return 16;
+
+			default: return 0;
+		}
+	}
+
+	CPUBuffer CompressTexture(const CPUBuffer& pixels, std::uint32_t width, std::uint32_t height, VkFormat format)
+	{
+		void(*encode)(const Internal::TexelBlock&, std::uint8_t*) = nullptr;
+		switch(format)
+		{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK: encode = &Internal::EncodeColorBlock; break;
+
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			{
+				encode = [](const Internal::TexelBlock& block, std::uint8_t* dst)
+				{
+					Internal::EncodeAlphaBlock(block, dst);
+					Internal::EncodeColorBlock(block, dst + 8);
+				};
+				break;
+			}
+
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK: encode = &Internal::EncodeBC7Block; break;
+
+			default:
+			{
+				Error("Texture compression: unsupported target format");
+				return {};
+			}
+		}
+		if(pixels.GetSize() < static_cast<std::size_t>(width) * height * 4)
+		{
+			Error("Texture compression: pixels buffer is too small for a %x% image", width, height);
+			return {};
+		}
+
+		std::uint32_t blocks_x = (width + 3) / 4;
+		std::uint32_t blocks_y = (height + 3) / 4;
+		std::uint32_t block_size = GetFormatBlockSize(format);
+		CPUBuffer compressed(ComputeCompressedLevelSize(format, width, height));
+		Internal::TexelBlock block;
+		for(std::uint32_t y = 0; y < blocks_y; y++)
+		{
+			for(std::uint32_t x = 0; x < blocks_x; x++)
+			{
+				Internal::FetchBlock(pixels.GetData(), width, height, x, y, block);
+				encode(block, compressed.GetData() + (y * blocks_x + x) * block_size);
+			}
+		}
+		return compressed;
+	}
+}
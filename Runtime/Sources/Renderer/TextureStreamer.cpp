@@ -0,0 +1,185 @@
+#include <cstring>
+#include <algorithm>
+
+#include <Renderer/TextureStreamer.h>
+#include <Renderer/RenderCore.h>
+#include <Core/Logs.h>
+
+namespace Scop
+{
+	void TextureStreamer::Init(std::size_t budget) noexcept
+	{
+		m_budget = budget;
+		Message("Vulkan: texture streamer created (% MiB budget)", m_budget / (1024 * 1024));
+	}
+
+	std::size_t TextureStreamer::GetResidentSize(const Entry& entry, std::uint32_t level) const noexcept
+	{
+		std::size_t size = 0;
+		for(std::uint32_t i = level; i < entry.mips.size(); i++)
+			size += entry.mips[i].GetSize();
+		return size;
+	}
+
+	void TextureStreamer::RecordMipsTransfer(Texture& texture, const Entry& entry, Image& image, std::uint32_t level, VkCommandBuffer cmd)
+	{
+		image.TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd);
+
+		// Mips already on the GPU are copied from the current image
+		std::uint32_t first_resident = std::max(level, entry.resident_level);
+		if(first_resident < entry.mips.size())
+		{
+			std::vector<VkImageCopy> regions;
+			for(std::uint32_t mip = first_resident; mip < entry.mips.size(); mip++)
+			{
+				VkImageCopy& region = regions.emplace_back();
+				region = {};
+				region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - entry.resident_level, 0, 1 };
+				region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - level, 0, 1 };
+				region.extent = { std::max(entry.width >> mip, 1u), std::max(entry.height >> mip, 1u), 1 };
+			}
+			texture.TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, cmd);
+			RenderCore::Get().vkCmdCopyImage(cmd, texture.Get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.Get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+		}
+
+		// Only the new finer mips come from the CPU
+		if(level < entry.resident_level)
+		{
+			std::size_t size = 0;
+			for(std::uint32_t mip = level; mip < entry.resident_level; mip++)
+				size += entry.mips[mip].GetSize();
+			CPUBuffer data(size);
+			std::vector<VkBufferImageCopy> regions;
+			std::size_t offset = 0;
+			for(std::uint32_t mip = level; mip < entry.resident_level; mip++)
+			{
+				std::memcpy(data.GetData() + offset, entry.mips[mip].GetData(), entry.mips[mip].GetSize());
+				VkBufferImageCopy& region = regions.emplace_back();
+				region = {};
+				region.bufferOffset = offset;
+				region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - level, 0, 1 };
+				region.imageExtent = { std::max(entry.width >> mip, 1u), std::max(entry.height >> mip, 1u), 1 };
+				offset += entry.mips[mip].GetSize();
+			}
+			GPUBuffer staging_buffer;
+			staging_buffer.Init(BufferType::Staging, data.GetSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, std::move(data));
+			for(VkBufferImageCopy& region : regions)
+				region.bufferOffset += staging_buffer.GetOffset();
+			RenderCore::Get().vkCmdCopyBufferToImage(cmd, staging_buffer.Get(), image.Get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+			m_retired_staging_buffers.emplace_back(staging_buffer, m_frame);
+		}
+
+		image.TransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cmd);
+	}
+
+	void TextureStreamer::MakeResident(Texture& texture, Entry& entry, std::uint32_t level, VkCommandBuffer cmd)
+	{
+		Image image;
+		// Transfer source too, the next resident change copies its mips instead of uploading them again
+		image.Init(ImageType::Color, std::max(entry.width >> level, 1u), std::max(entry.height >> level, 1u), entry.format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, {}, false, entry.mips.size() - level);
+		image.CreateImageView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, 1, GetTextureComponentMapping(entry.format));
+		image.CreateSampler();
+		if(cmd == VK_NULL_HANDLE || !texture.IsInit())
+			image.UploadMipLevels(entry.mips, level);
+		else
+			RecordMipsTransfer(texture, entry, image, level, cmd);
+
+		texture.SwapStorage(image);
+		if(image.IsInit())
+			m_retired_images.emplace_back(image, m_frame);
+		texture.RefreshBindless();
+
+		m_resident_size -= GetResidentSize(entry, entry.resident_level);
+		m_resident_size += GetResidentSize(entry, level);
+		entry.resident_level = level;
+	}
+
+	void TextureStreamer::Register(Texture& texture, std::vector<CPUBuffer> mips, VkFormat format)
+	{
+		Entry entry;
+		entry.mips = std::move(mips);
+		entry.format = format;
+		entry.width = texture.GetWidth();
+		entry.height = texture.GetHeight();
+		entry.coarse_level = 0;
+		while(entry.coarse_level + 1 < entry.mips.size() && std::max(entry.width >> entry.coarse_level, entry.height >> entry.coarse_level) > STREAMING_COARSE_MIP_SIZE)
+			entry.coarse_level++;
+		entry.resident_level = static_cast<std::uint32_t>(entry.mips.size()); // Nothing resident yet
+
+		auto [it, _] = m_entries.insert_or_assign(&texture, std::move(entry));
+		MakeResident(texture, it->second, it->second.coarse_level);
+		texture.m_last_use_frame = m_frame;
+	}
+
+	void TextureStreamer::Unregister(Texture& texture) noexcept
+	{
+		auto it = m_entries.find(&texture);
+		if(it == m_entries.end())
+			return;
+		m_resident_size -= GetResidentSize(it->second, it->second.resident_level);
+		m_entries.erase(it);
+	}
+
+	void TextureStreamer::Update(VkCommandBuffer cmd)
+	{
+		m_frame++;
+		std::erase_if(m_retired_images, [this](auto& retired)
+		{
+			if(retired.second + MAX_FRAMES_IN_FLIGHT > m_frame)
+				return false;
+			retired.first.DestroyWithoutSync();
+			return true;
+		});
+		std::erase_if(m_retired_staging_buffers, [this](auto& retired)
+		{
+			if(retired.second + MAX_FRAMES_IN_FLIGHT > m_frame)
+				return false;
+			retired.first.Destroy();
+			return true;
+		});
+
+		Texture* candidate = nullptr;
+		for(auto& [texture, entry] : m_entries)
+		{
+			// Only textures drawn during the last frame are worth refining
+			if(entry.resident_level == 0 || texture->GetLastUseFrame() + 1 < m_frame)
+				continue;
+			if(candidate == nullptr || texture->GetLastUseFrame() > candidate->GetLastUseFrame())
+				candidate = texture;
+		}
+		if(candidate == nullptr)
+			return;
+
+		Entry& entry = m_entries[candidate];
+		std::size_t cost = entry.mips[entry.resident_level - 1].GetSize();
+		while(m_resident_size + cost > m_budget)
+		{
+			Texture* victim = nullptr;
+			for(auto& [texture, other] : m_entries)
+			{
+				if(texture == candidate || other.resident_level >= other.coarse_level || texture->GetLastUseFrame() >= candidate->GetLastUseFrame())
+					continue;
+				if(victim == nullptr || texture->GetLastUseFrame() < victim->GetLastUseFrame())
+					victim = texture;
+			}
+			if(victim == nullptr)
+				return; // Everything resident is in use, stay at the current quality
+			Entry& victim_entry = m_entries[victim];
+			MakeResident(*victim, victim_entry, victim_entry.resident_level + 1, cmd);
+		}
+		MakeResident(*candidate, entry, entry.resident_level - 1, cmd);
+	}
+
+	void TextureStreamer::Destroy() noexcept
+	{
+		for(auto& [image, _] : m_retired_images)
+			image.DestroyWithoutSync();
+		m_retired_images.clear();
+		for(auto& [buffer, _] : m_retired_staging_buffers)
+			buffer.Destroy();
+		m_retired_staging_buffers.clear();
+		m_entries.clear();
+		m_resident_size = 0;
+		Message("Vulkan: texture streamer destroyed");
+	}
+}
@@ -125,6 +125,7 @@ int32_t kvfFindDeviceQueueFamily(VkPhysicalDevice physical, KvfQueueType type);
 
 VkDevice kvfCreateDefaultDevice(VkPhysicalDevice physical);
 VkDevice kvfCreateDevice(VkPhysicalDevice physical, const char** extensions, uint32_t extensions_count, VkPhysicalDeviceFeatures* features);
+VkDevice kvfCreateDeviceWithNext(VkPhysicalDevice physical, const char** extensions, uint32_t extensions_count, VkPhysicalDeviceFeatures* features, const void* next);
 VkDevice kvfCreateDefaultDevicePhysicalDeviceAndCustomQueues(VkPhysicalDevice physical, int32_t graphics_queue, int32_t present_queue, int32_t compute_queue);
 VkDevice kvfCreateDeviceCustomPhysicalDeviceAndQueues(VkPhysicalDevice physical, const char** extensions, uint32_t extensions_count, VkPhysicalDeviceFeatures* features, int32_t graphics_queue, int32_t present_queue, int32_t compute_queue);
 #ifdef KVF_IMPL_VK_NO_PROTOTYPES
@@ -1525,6 +1526,11 @@ VkDevice kvfCreateDefaultDevice(VkPhysicalDevice physical)
 }
 
 VkDevice kvfCreateDevice(VkPhysicalDevice physical, const char** extensions, uint32_t extensions_count, VkPhysicalDeviceFeatures* features)
+{
+	return kvfCreateDeviceWithNext(physical, extensions, extensions_count, features, NULL);
+}
+
+VkDevice kvfCreateDeviceWithNext(VkPhysicalDevice physical, const char** extensions, uint32_t extensions_count, VkPhysicalDeviceFeatures* features, const void* next)
 {
 	const float queue_priority = 1.0f;
 
@@ -1581,7 +1587,7 @@ VkDevice kvfCreateDevice(VkPhysicalDevice physical, const char** extensions, uin
 	createInfo.enabledLayerCount = 0;
 	createInfo.ppEnabledLayerNames = NULL;
 	createInfo.flags = 0;
-	createInfo.pNext = NULL;
+	createInfo.pNext = next;
 
 	VkDevice device;
 	__kvfCheckVk(KVF_GET_INSTANCE_FUNCTION(vkCreateDevice)(physical, &createInfo, NULL, &device));
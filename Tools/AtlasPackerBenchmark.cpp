@@ -0,0 +1,47 @@
+// CPU benchmark of the sprite atlas packer
+// Usage: atlas_packer_benchmark [rect_count] [page_size] [iterations]
+
+#include <chrono>
+#include <random>
+#include <string>
+
+#include <Graphics/AtlasPacker.h>
+#include <Core/Logs.h>
+
+int main(int argc, char** argv)
+{
+	using namespace Scop;
+
+	std::size_t rect_count = (argc > 1 ? std::stoul(argv[1]) : 10000);
+	std::uint32_t page_size = (argc > 2 ? std::stoul(argv[2]) : 2048);
+	std::size_t iterations = (argc > 3 ? std::stoul(argv[3]) : 10);
+
+	// Typical UI sprites and icons, plus the padding the texture atlas adds
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<std::uint32_t> distribution(8, 66);
+	std::vector<Vec2ui> sizes(rect_count);
+	std::uint64_t area = 0;
+	for(Vec2ui& size : sizes)
+	{
+		size = Vec2ui{ distribution(generator), distribution(generator) };
+		area += std::uint64_t(size.x) * size.y;
+	}
+
+	std::vector<AtlasRect> rects;
+	std::uint32_t page_count = 0;
+	auto start = std::chrono::steady_clock::now();
+	for(std::size_t i = 0; i < iterations; i++)
+	{
+		if(!PackAtlasRects(sizes, page_size, rects, page_count))
+		{
+			Error("atlas packer benchmark: a rectangle does not fit in a %x% page", page_size, page_size);
+			return 1;
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+	double occupancy = static_cast<double>(area) / (static_cast<double>(page_count) * page_size * page_size);
+	Message("atlas packer benchmark: % rects in % pages of %x% (% occupancy)", rect_count, page_count, page_size, page_size, occupancy);
+	Message("atlas packer benchmark: %ms per pack, % rects/s", seconds * 1000.0, static_cast<std::uint64_t>(rect_count / seconds));
+	return 0;
+}
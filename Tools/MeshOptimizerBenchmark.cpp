@@ -0,0 +1,115 @@
+// CPU benchmark of the mesh optimisation pass, reports vertex cache efficiency before and after
+// Usage: mesh_optimizer_benchmark [grid_size] [model.obj]
+
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <algorithm>
+
+#include <Graphics/MeshOptimizer.h>
+#include <Graphics/Loaders/OBJ.h>
+#include <Core/Logs.h>
+
+namespace
+{
+	using namespace Scop;
+
+	struct BenchmarkMesh
+	{
+		std::string name;
+		std::vector<Vertex> vertices;
+		std::vector<std::uint32_t> indices;
+	};
+
+	// Row by row, like most generated terrains and exported scans
+	BenchmarkMesh CreateGrid(std::uint32_t size)
+	{
+		BenchmarkMesh mesh;
+		mesh.name = "grid " + std::to_string(size) + "x" + std::to_string(size);
+		for(std::uint32_t y = 0; y <= size; y++)
+		{
+			for(std::uint32_t x = 0; x <= size; x++)
+			{
+				Vertex vertex;
+				vertex.position = Vec4f{ static_cast<float>(x), static_cast<float>(y), std::sin(x * 0.1f) * std::cos(y * 0.1f), 1.0f };
+				mesh.vertices.push_back(vertex);
+			}
+		}
+		for(std::uint32_t y = 0; y < size; y++)
+		{
+			for(std::uint32_t x = 0; x < size; x++)
+			{
+				std::uint32_t corner = y * (size + 1) + x;
+				mesh.indices.insert(mesh.indices.end(), { corner, corner + 1, corner + size + 2, corner + size + 2, corner + size + 1, corner });
+			}
+		}
+		return mesh;
+	}
+
+	// Triangles in no particular order, the worst case for the cache
+	BenchmarkMesh Shuffle(BenchmarkMesh mesh)
+	{
+		std::mt19937 generator(42);
+		std::vector<std::uint32_t> triangles(mesh.indices.size() / 3);
+		for(std::uint32_t i = 0; i < triangles.size(); i++)
+			triangles[i] = i;
+		std::shuffle(triangles.begin(), triangles.end(), generator);
+		std::vector<std::uint32_t> indices;
+		indices.reserve(mesh.indices.size());
+		for(std::uint32_t triangle : triangles)
+			indices.insert(indices.end(), mesh.indices.begin() + triangle * 3, mesh.indices.begin() + triangle * 3 + 3);
+		mesh.indices.swap(indices);
+		mesh.name = "shuffled " + mesh.name;
+		return mesh;
+	}
+
+	void AddObjMeshes(const std::filesystem::path& path, std::vector<BenchmarkMesh>& meshes)
+	{
+		auto obj_data = LoadObjFromFile(path);
+		if(!obj_data)
+			return;
+		TesselateObjData(*obj_data);
+		ObjModel obj_model = ConvertObjDataToObjModel(*obj_data);
+		obj_data.reset();
+		for(auto& [group, faces] : obj_model.faces)
+		{
+			BenchmarkMesh& mesh = meshes.emplace_back();
+			mesh.name = path.filename().string() + " (" + group + ")";
+			mesh.vertices.resize(obj_model.vertex.size());
+			for(std::size_t i = 0; i < obj_model.vertex.size(); i++)
+				mesh.vertices[i].position = Vec4f{ obj_model.vertex[i], 1.0f };
+			mesh.indices = faces;
+			OptimizeVertexFetch(mesh.vertices, mesh.indices); // Groups share the model vertices
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace Scop;
+
+	std::uint32_t grid_size = (argc > 1 ? std::stoul(argv[1]) : 512);
+
+	std::vector<BenchmarkMesh> meshes;
+	meshes.push_back(CreateGrid(grid_size));
+	meshes.push_back(Shuffle(CreateGrid(grid_size)));
+	if(argc > 2)
+		AddObjMeshes(argv[2], meshes);
+
+	for(BenchmarkMesh& mesh : meshes)
+	{
+		VertexCacheStatistics before = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+		VertexCacheStatistics before_32 = AnalyzeVertexCache(mesh.indices, mesh.vertices.size(), 32);
+		auto start = std::chrono::steady_clock::now();
+		OptimizeMesh(mesh.vertices, mesh.indices);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		VertexCacheStatistics after = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+		VertexCacheStatistics after_32 = AnalyzeVertexCache(mesh.indices, mesh.vertices.size(), 32);
+
+		Message("mesh optimizer benchmark: % (% triangles) optimised in %ms, % triangles/s", mesh.name, mesh.indices.size() / 3, seconds * 1000.0, static_cast<std::uint64_t>(mesh.indices.size() / 3 / seconds));
+		Message("mesh optimizer benchmark:   16 entries cache, ACMR % -> %, ATVR % -> %", before.acmr, after.acmr, before.atvr, after.atvr);
+		Message("mesh optimizer benchmark:   32 entries cache, ACMR % -> %, ATVR % -> %", before_32.acmr, after_32.acmr, before_32.atvr, after_32.atvr);
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+// Offline converter from BMP images to block compressed SCTX textures
+// Usage: texture_compiler <input.bmp> <output.sctx> [--format=bc1|bc3|bc7] [--linear] [--no-mipmaps]
+
+#include <string_view>
+
+#include <Graphics/Loaders/BMP.h>
+#include <Graphics/Loaders/SCTX.h>
+#include <Renderer/TextureCompression.h>
+#include <Core/Logs.h>
+
+int main(int argc, char** argv)
+{
+	using namespace Scop;
+
+	if(argc < 3)
+	{
+		Error("usage: texture_compiler <input.bmp> <output.sctx> [--format=bc1|bc3|bc7] [--linear] [--no-mipmaps]");
+		return 1;
+	}
+
+	std::string_view format_name = "bc7";
+	bool linear = false;
+	bool mipmaps = true;
+	for(int i = 3; i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		if(arg.starts_with("--format="))
+			format_name = arg.substr(9);
+		else if(arg == "--linear")
+			linear = true;
+		else if(arg == "--no-mipmaps")
+			mipmaps = false;
+		else
+			Warning("texture compiler: unknown argument %", arg);
+	}
+
+	VkFormat format;
+	if(format_name == "bc1")
+		format = (linear ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : VK_FORMAT_BC1_RGB_SRGB_BLOCK);
+	else if(format_name == "bc3")
+		format = (linear ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC3_SRGB_BLOCK);
+	else if(format_name == "bc7")
+		format = (linear ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_BC7_SRGB_BLOCK);
+	else
+	{
+		Error("texture compiler: unknown format %", format_name);
+		return 1;
+	}
+
+	Vec2ui32 dimensions;
+	CPUBuffer pixels = LoadBMPFile(argv[1], dimensions);
+	if(!pixels)
+		return 1;
+
+	std::vector<CPUBuffer> levels;
+	if(mipmaps)
+		levels = GenerateMipChain(pixels, dimensions.x, dimensions.y);
+	else
+		levels.push_back(pixels.Duplicate());
+
+	std::vector<CPUBuffer> compressed;
+	compressed.reserve(levels.size());
+	std::size_t raw_size = 0;
+	std::size_t compressed_size = 0;
+	for(std::size_t i = 0; i < levels.size(); i++)
+	{
+		compressed.push_back(CompressTexture(levels[i], std::max(dimensions.x >> i, 1u), std::max(dimensions.y >> i, 1u), format));
+		raw_size += levels[i].GetSize();
+		compressed_size += compressed.back().GetSize();
+	}
+
+	if(!WriteSCTXFile(argv[2], format, dimensions, compressed))
+		return 1;
+	Message("texture compiler: % mips, % bytes instead of %", compressed.size(), compressed_size, raw_size);
+	return 0;
+}